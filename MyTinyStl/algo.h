@@ -7,6 +7,8 @@
 //
 
 #include "iterator.h"
+#include "util.h"
+#include <type_traits>
 
 namespace mystl
 {
@@ -20,6 +22,27 @@ InputIter find(InputIter first, InputIter last, const T& value) {
     return first;
 }
 
+// find 的 deque 迭代器版本， 逐个缓冲区在连续内存上查找
+template <class T, class Ref, class Ptr, size_t BufSiz>
+struct __deque_iterator;
+
+template <class T, class Ref, class Ptr, size_t BufSiz, class U>
+__deque_iterator<T, Ref, Ptr, BufSiz>
+find(__deque_iterator<T, Ref, Ptr, BufSiz> first, __deque_iterator<T, Ref, Ptr, BufSiz> last, const U& value) {
+    typedef __deque_iterator<T, Ref, Ptr, BufSiz> iter;
+    for (typename iter::map_pointer node = first.node; ; ) {
+        T* seg_end = node == last.node ? last.cur : first.last;
+        T* pos = mystl::find(first.cur, seg_end, value);
+        if (pos != seg_end || node == last.node) {
+            first.cur = pos;
+            return first;
+        }
+        ++node;
+        first.set_node(node);
+        first.cur = first.first;
+    }
+}
+
 // lower_bound
 // 前向迭代器寻找方式
 template <class ForwardIter, class T, class Distance>
@@ -64,6 +87,71 @@ ForwardIter lower_bound(ForwardIter first, ForwardIter last, const T& value) {
     return __lower_bound(first, last, value, mystl::distance_type(first), mystl::iterator_category(first));
 }
 
+/*****************************************************************************************/
+// remove_if
+// 移除 [first, last) 内所有令 pred 为 true 的元素，幸存元素只搬移一次，返回新的结尾
+// 并不真正删除元素， 容器需要再对 [返回值, last) 调用 erase
+/*****************************************************************************************/
+
+// 一般版本， 只搬移幸存元素
+template <class ForwardIter, class Predicate>
+ForwardIter __remove_if(ForwardIter first, ForwardIter last, Predicate pred) {
+    // 第一个被移除元素之前的元素不需要搬移
+    while (first != last && !pred(*first))
+        ++first;
+    if (first == last) return first;
+    ForwardIter result = first;
+    for (++first; first != last; ++first) {
+        if (!pred(*first)) {
+            *result = mystl::move(*first);
+            ++result;
+        }
+    }
+    return result;
+}
+
+// 以下版本适用于 "指针所指之对象 trivially copyable"
+// 无分支写法: 每个元素都写到 result, result 按 !pred 前进, 编译器可以向量化这个循环
+template <class T, class Predicate>
+T* __remove_if_t(T* first, T* last, Predicate pred, std::true_type) {
+    while (first != last && !pred(*first))
+        ++first;
+    if (first == last) return first;
+    T* result = first;
+    for (++first; first != last; ++first) {
+        const T tmp = *first;
+        *result = tmp;
+        result += !pred(tmp);
+    }
+    return result;
+}
+
+template <class T, class Predicate>
+T* __remove_if_t(T* first, T* last, Predicate pred, std::false_type) {
+    return mystl::__remove_if(first, last, pred);
+}
+
+// __remove_if_dispatch, 一个完全泛化版本和一个指针偏特化版本
+template <class ForwardIter, class Predicate>
+struct __remove_if_dispatch
+{
+    ForwardIter operator()(ForwardIter first, ForwardIter last, Predicate pred) {
+        return mystl::__remove_if(first, last, pred);
+    }
+};
+
+template <class T, class Predicate>
+struct __remove_if_dispatch<T*, Predicate>
+{
+    T* operator()(T* first, T* last, Predicate pred) {
+        return mystl::__remove_if_t(first, last, pred, std::is_trivially_copyable<T>{});
+    }
+};
+
+template <class ForwardIter, class Predicate>
+inline ForwardIter remove_if(ForwardIter first, ForwardIter last, Predicate pred) {
+    return mystl::__remove_if_dispatch<ForwardIter, Predicate>()(first, last, pred);
+}
 
 }
 
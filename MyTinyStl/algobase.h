@@ -5,6 +5,7 @@
 #include "util.h"
 #include <type_traits>
 #include <string>
+#include <cstring>
 //
 // Created by fengjiaxin on 2023/4/11.
 // 这个头文件 包含了 mystl 的基本算法(比较简单的)
@@ -76,7 +77,8 @@ inline OutputIter __copy(RandomAccessIter first, RandomAccessIter last, OutputIt
 // 以下版本适用于 "指针所指之对象具备 trivial assignment operator"
 template <class T>
 inline T* __copy_t(const T* first, const T* last, T* result, std::true_type) {
-    std::memmove(result, first, sizeof(T) * (last - first));
+    if (last != first) // 空区间的指针可能是 nullptr
+        std::memmove(result, first, sizeof(T) * (last - first));
     return result + (last - first);
 }
 
@@ -169,13 +171,15 @@ inline OutputIter __move(RandomAccessIter first, RandomAccessIter last, OutputIt
 // 以下版本适用于 "指针所指之对象具备 trivial assignment operator"
 template <class T>
 inline T* __move_t(const T* first, const T* last, T* result, std::true_type) {
-    std::memmove(result, first, sizeof(T) * (last - first));
+    if (last != first) // 空区间的指针可能是 nullptr
+        std::memmove(result, first, sizeof(T) * (last - first));
     return result + (last - first);
 }
 
 // 以下版本适用于 "指针所指之对象具备 non-trivial assignment operator"
-template <class T>
-inline T* __move_t(const T* first, const T* last, T* result, std::false_type) {
+// 源指针保留 const 与否， 非 const 时才能真正调用移动赋值
+template <class T, class U>
+inline U* __move_t(T* first, T* last, U* result, std::false_type) {
     // 原生指针 是一种 randomAccessIterator
     return mystl::__move_d(first, last, result, (ptrdiff_t*)0);
 }
@@ -275,7 +279,8 @@ struct __copy_backward_dispatch
 template <class T>
 T* __copy_backward_t(const T* first, const T* last, T* res, std::true_type) {
     const ptrdiff_t N = last - first;
-    std::memmove(res - N, first, sizeof(T) * N);
+    if (N != 0)
+        std::memmove(res - N, first, sizeof(T) * N);
     return res - N;
 }
 
@@ -304,6 +309,213 @@ inline BidirectionalIter2 copy_backward(BidirectionalIter1 first, BidirectionalI
     return __copy_backward_dispatch<BidirectionalIter1, BidirectionalIter2>()(first, last, res);
 }
 
+/*****************************************************************************************/
+// move_backward
+// 把 [first, last)区间内的元素移动到 [result - (last - first),result), 从后往前move
+/*****************************************************************************************/
+template <class BidirectionalIter1, class BidirectionalIter2>
+inline BidirectionalIter2 __move_backward(BidirectionalIter1 first, BidirectionalIter1 last, BidirectionalIter2 res) {
+    while (first != last)
+        *--res = mystl::move(*--last);
+    return res;
+}
+
+template <class BidirectionalIter1, class BidirectionalIter2>
+struct __move_backward_dispatch
+{
+    BidirectionalIter2 operator()(BidirectionalIter1 first, BidirectionalIter1 last, BidirectionalIter2 res) {
+        return mystl::__move_backward(first, last, res);
+    }
+};
+
+// 指针类型， 指向对象可以 trivially move assign, 直接 memmove
+template <class T>
+T* __move_backward_t(const T* first, const T* last, T* res, std::true_type) {
+    const ptrdiff_t N = last - first;
+    if (N != 0)
+        std::memmove(res - N, first, sizeof(T) * N);
+    return res - N;
+}
+
+template <class T>
+T* __move_backward_t(T* first, T* last, T* res, std::false_type) {
+    return mystl::__move_backward(first, last, res);
+}
+
+template <class T>
+struct __move_backward_dispatch<T*, T*> {
+    T* operator()(T* first, T* last, T* res) {
+        return __move_backward_t(first, last, res, std::is_trivially_move_assignable<T>{});
+    }
+};
+
+template <class BidirectionalIter1, class BidirectionalIter2>
+inline BidirectionalIter2 move_backward(BidirectionalIter1 first, BidirectionalIter1 last, BidirectionalIter2 res) {
+    return __move_backward_dispatch<BidirectionalIter1, BidirectionalIter2>()(first, last, res);
+}
+
+
+/*****************************************************************************************/
+// deque 迭代器的分段版本
+// deque 的元素分布在多个连续的缓冲区内， 逐元素处理时每次 ++ 都要检查是否越过缓冲区
+// 以下版本按缓冲区逐段处理， 每一段调用原生指针版本(trivial 型别可以走 memmove)
+/*****************************************************************************************/
+template <class T, class Ref, class Ptr, size_t BufSiz>
+struct __deque_iterator;
+
+// copy: deque -> 指针
+template <class T, class Ref, class Ptr, size_t BufSiz>
+T* copy(__deque_iterator<T, Ref, Ptr, BufSiz> first, __deque_iterator<T, Ref, Ptr, BufSiz> last, T* result) {
+    typedef __deque_iterator<T, Ref, Ptr, BufSiz> iter;
+    if (first.node == last.node)
+        return mystl::copy(first.cur, last.cur, result);
+    result = mystl::copy(first.cur, first.last, result);
+    for (typename iter::map_pointer node = first.node + 1; node != last.node; ++node)
+        result = mystl::copy(*node, *node + iter::buffer_size, result);
+    return mystl::copy(last.first, last.cur, result);
+}
+
+// copy: 指针 -> deque
+template <class T, size_t BufSiz>
+__deque_iterator<T, T&, T*, BufSiz>
+__copy_to_deque(const T* first, const T* last, __deque_iterator<T, T&, T*, BufSiz> result) {
+    ptrdiff_t n = last - first;
+    while (n > 0) {
+        const ptrdiff_t room = result.last - result.cur;
+        const ptrdiff_t len = n < room ? n : room;
+        mystl::copy(first, first + len, result.cur);
+        first += len;
+        result += len;
+        n -= len;
+    }
+    return result;
+}
+
+template <class T, size_t BufSiz>
+inline __deque_iterator<T, T&, T*, BufSiz>
+copy(const T* first, const T* last, __deque_iterator<T, T&, T*, BufSiz> result) {
+    return mystl::__copy_to_deque(first, last, result);
+}
+
+template <class T, size_t BufSiz>
+inline __deque_iterator<T, T&, T*, BufSiz>
+copy(T* first, T* last, __deque_iterator<T, T&, T*, BufSiz> result) {
+    return mystl::__copy_to_deque(static_cast<const T*>(first), static_cast<const T*>(last), result);
+}
+
+// copy: deque -> deque, 每次取两边缓冲区剩余长度的较小者
+template <class T, class Ref, class Ptr, size_t BufSiz>
+__deque_iterator<T, T&, T*, BufSiz>
+copy(__deque_iterator<T, Ref, Ptr, BufSiz> first, __deque_iterator<T, Ref, Ptr, BufSiz> last,
+     __deque_iterator<T, T&, T*, BufSiz> result) {
+    ptrdiff_t n = last - first;
+    while (n > 0) {
+        const ptrdiff_t src = first.last - first.cur;
+        const ptrdiff_t dst = result.last - result.cur;
+        ptrdiff_t len = src < dst ? src : dst;
+        if (n < len) len = n;
+        mystl::copy(static_cast<const T*>(first.cur), static_cast<const T*>(first.cur + len), result.cur);
+        first += len;
+        result += len;
+        n -= len;
+    }
+    return result;
+}
+
+// copy_backward: deque -> deque, 从后往前逐段处理
+template <class T, class Ref, class Ptr, size_t BufSiz>
+__deque_iterator<T, T&, T*, BufSiz>
+copy_backward(__deque_iterator<T, Ref, Ptr, BufSiz> first, __deque_iterator<T, Ref, Ptr, BufSiz> last,
+              __deque_iterator<T, T&, T*, BufSiz> result) {
+    typedef __deque_iterator<T, Ref, Ptr, BufSiz> iter;
+    ptrdiff_t n = last - first;
+    while (n > 0) {
+        // 位于缓冲区头部时， 可用的一段在前一个缓冲区
+        ptrdiff_t src = last.cur - last.first;
+        T* src_end = last.cur;
+        if (src == 0) {
+            src = iter::buffer_size;
+            src_end = *(last.node - 1) + iter::buffer_size;
+        }
+        ptrdiff_t dst = result.cur - result.first;
+        T* dst_end = result.cur;
+        if (dst == 0) {
+            dst = iter::buffer_size;
+            dst_end = *(result.node - 1) + iter::buffer_size;
+        }
+        ptrdiff_t len = src < dst ? src : dst;
+        if (n < len) len = n;
+        mystl::copy_backward(static_cast<const T*>(src_end - len), static_cast<const T*>(src_end), dst_end);
+        last -= len;
+        result -= len;
+        n -= len;
+    }
+    return result;
+}
+
+// move: deque -> deque, 同 copy
+template <class T, size_t BufSiz>
+__deque_iterator<T, T&, T*, BufSiz>
+move(__deque_iterator<T, T&, T*, BufSiz> first, __deque_iterator<T, T&, T*, BufSiz> last,
+     __deque_iterator<T, T&, T*, BufSiz> result) {
+    ptrdiff_t n = last - first;
+    while (n > 0) {
+        const ptrdiff_t src = first.last - first.cur;
+        const ptrdiff_t dst = result.last - result.cur;
+        ptrdiff_t len = src < dst ? src : dst;
+        if (n < len) len = n;
+        mystl::move(first.cur, first.cur + len, result.cur);
+        first += len;
+        result += len;
+        n -= len;
+    }
+    return result;
+}
+
+// move_backward: deque -> deque, 同 copy_backward
+template <class T, size_t BufSiz>
+__deque_iterator<T, T&, T*, BufSiz>
+move_backward(__deque_iterator<T, T&, T*, BufSiz> first, __deque_iterator<T, T&, T*, BufSiz> last,
+              __deque_iterator<T, T&, T*, BufSiz> result) {
+    typedef __deque_iterator<T, T&, T*, BufSiz> iter;
+    ptrdiff_t n = last - first;
+    while (n > 0) {
+        ptrdiff_t src = last.cur - last.first;
+        T* src_end = last.cur;
+        if (src == 0) {
+            src = iter::buffer_size;
+            src_end = *(last.node - 1) + iter::buffer_size;
+        }
+        ptrdiff_t dst = result.cur - result.first;
+        T* dst_end = result.cur;
+        if (dst == 0) {
+            dst = iter::buffer_size;
+            dst_end = *(result.node - 1) + iter::buffer_size;
+        }
+        ptrdiff_t len = src < dst ? src : dst;
+        if (n < len) len = n;
+        mystl::move_backward(src_end - len, src_end, dst_end);
+        last -= len;
+        result -= len;
+        n -= len;
+    }
+    return result;
+}
+
+// fill: 逐段填充
+template <class T, size_t BufSiz, class U>
+void fill(__deque_iterator<T, T&, T*, BufSiz> first, __deque_iterator<T, T&, T*, BufSiz> last, const U& value) {
+    typedef __deque_iterator<T, T&, T*, BufSiz> iter;
+    if (first.node == last.node) {
+        mystl::fill(first.cur, last.cur, value);
+        return;
+    }
+    mystl::fill(first.cur, first.last, value);
+    for (typename iter::map_pointer node = first.node + 1; node != last.node; ++node)
+        mystl::fill(*node, *node + iter::buffer_size, value);
+    mystl::fill(last.first, last.cur, value);
+}
+
 }
 
 #endif //FJXTINYSTL_ALGOBASE_H
@@ -6,17 +6,26 @@
 // 内存池分配， 测试， 参考stl的 alloc
 #include <cstddef> // size_t
 #include <stdlib.h> // malloc, free
+#include <cstring> // memcpy
 #include <iostream>
+#include <mutex>
 
 namespace mystl {
 
 // 分配器， 分配的size 按照是否 > 128 byte
 // 1. 大于 128 byte, 通过malloc分配内存
 // 2. 小于 128 byte, 通过 内存池的方式分配内存
+// 和 SGI 一样写成模板， 静态成员定义在头文件里， 被多个翻译单元包含时也不会重复定义
+// 和 SGI 的 __NODE_ALLOCATOR_THREADS 一样， 取 free list 和 refill 时加锁， 不同线程可以同时使用
+// 确定只在单线程中使用时可以定义 ALLOC_THREADS 为 0 去掉加锁
 
+#ifndef ALLOC_THREADS
+#define ALLOC_THREADS 1
+#endif
 
 // 请求内存 > 128 byte
-class malloc_alloc {
+template <int inst>
+class __malloc_alloc_template {
 private:
     static void* oom_malloc(size_t);
     static void* oom_realloc(void*, size_t);
@@ -38,16 +47,18 @@ public:
     }
 
     typedef void (*H)(); // 定义函数指针
-    H set_malloc_handler(H f) {
+    static H set_malloc_handler(H f) {
         H old = malloc_alloc_oom_handler;
         malloc_alloc_oom_handler = f;
         return old;
     }
 };
 
-void (*malloc_alloc::malloc_alloc_oom_handler)() = nullptr;
+template <int inst>
+void (*__malloc_alloc_template<inst>::malloc_alloc_oom_handler)() = nullptr;
 
-void* malloc_alloc::oom_malloc(size_t n) {
+template <int inst>
+void* __malloc_alloc_template<inst>::oom_malloc(size_t n) {
     typedef void (*H)(); // 定义函数指针
     H my_alloc_handler;
     void* res;
@@ -64,7 +75,8 @@ void* malloc_alloc::oom_malloc(size_t n) {
     }
 }
 
-void* malloc_alloc::oom_realloc(void* p, size_t n) {
+template <int inst>
+void* __malloc_alloc_template<inst>::oom_realloc(void* p, size_t n) {
     typedef void (*H)(); // 定义函数指针
     H my_alloc_handler;
     void* res;
@@ -81,8 +93,11 @@ void* malloc_alloc::oom_realloc(void* p, size_t n) {
 }
 
 
+typedef __malloc_alloc_template<0> malloc_alloc;
+
 // 二级分配器， <= 128 byte的内存从这里分配
-class default_alloc {
+template <int inst>
+class __default_alloc_template {
 
 private:
     static const int ALIGN = 8;
@@ -111,6 +126,16 @@ private:
     static char* end_free;
     static size_t heap_size;
 
+#if ALLOC_THREADS
+    static std::mutex pool_mutex;
+    typedef std::lock_guard<std::mutex> lock;
+#else
+    struct lock {
+        explicit lock(int) {}
+    };
+    static const int pool_mutex = 0;
+#endif
+
 public:
     // n must be > 0
     static void* allocate(size_t n) {
@@ -119,6 +144,7 @@ public:
         if (n > static_cast<size_t>(MAX_BYTES)) {
             return malloc_alloc::allocate(n);
         }
+        lock guard(pool_mutex); // refill 也在锁内
         my_free_list = free_list + FREELIST_INDEX(n);
         result = *my_free_list;
         if (nullptr == result) {
@@ -136,6 +162,7 @@ public:
             malloc_alloc::deallocate(p, n);
             return;
         }
+        lock guard(pool_mutex);
         my_free_list = free_list + FREELIST_INDEX(n);
         q->free_list_link = *my_free_list;
         *my_free_list = q;
@@ -144,10 +171,12 @@ public:
 
 };
 
+typedef __default_alloc_template<0> default_alloc;
 typedef default_alloc alloc;
 
 // 该方法是从战备池中找地址，如果不够，申请
-char* default_alloc::chunk_alloc(size_t size, int &nobjs) {
+template <int inst>
+char* __default_alloc_template<inst>::chunk_alloc(size_t size, int &nobjs) {
     char* result;
     size_t total_bytes = size * nobjs;
     size_t bytes_left = end_free - start_free;
@@ -186,16 +215,17 @@ char* default_alloc::chunk_alloc(size_t size, int &nobjs) {
                 }
             }
             end_free = nullptr;
+            // 交给一级分配器， 它会调用 oom 处理函数， 要么成功要么退出
             start_free = (char*)malloc_alloc::allocate(bytes_to_get);
-        } else {
-            heap_size += bytes_to_get;
-            end_free = start_free + bytes_to_get;
-            return chunk_alloc(size, nobjs);
         }
+        heap_size += bytes_to_get;
+        end_free = start_free + bytes_to_get;
+        return chunk_alloc(size, nobjs);
     }
 }
 
-void* default_alloc::refill(size_t n) {
+template <int inst>
+void* __default_alloc_template<inst>::refill(size_t n) {
     int nobjs = 20;
     char* chunk = chunk_alloc(n, nobjs);
     obj** my_free_list;
@@ -222,7 +252,8 @@ void* default_alloc::refill(size_t n) {
     return result;
 }
 
-void* default_alloc::reallocate(void* p, size_t old_sz, size_t new_sz) {
+template <int inst>
+void* __default_alloc_template<inst>::reallocate(void* p, size_t old_sz, size_t new_sz) {
     void* result;
     size_t copy_sz;
     if (old_sz > static_cast<size_t>(MAX_BYTES) && new_sz > static_cast<size_t>(MAX_BYTES) ) {
@@ -236,12 +267,37 @@ void* default_alloc::reallocate(void* p, size_t old_sz, size_t new_sz) {
     return result;
 }
 
-char* default_alloc::start_free = nullptr;
-char* default_alloc::end_free = nullptr;
-size_t default_alloc::heap_size = 0;
-default_alloc::obj* default_alloc::free_list[default_alloc::N_FREELISTS] =
+template <int inst>
+char* __default_alloc_template<inst>::start_free = nullptr;
+template <int inst>
+char* __default_alloc_template<inst>::end_free = nullptr;
+template <int inst>
+size_t __default_alloc_template<inst>::heap_size = 0;
+#if ALLOC_THREADS
+template <int inst>
+std::mutex __default_alloc_template<inst>::pool_mutex;
+#endif
+template <int inst>
+typename __default_alloc_template<inst>::obj*
+__default_alloc_template<inst>::free_list[__default_alloc_template<inst>::N_FREELISTS] =
         {nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,
          nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr};
+
+// 以对象为单位分配的包装， 容器的节点通过它使用内存池
+template <class T, class Alloc = alloc>
+class simple_alloc {
+public:
+    static T* allocate() { return reinterpret_cast<T*>(Alloc::allocate(sizeof(T))); }
+    static T* allocate(size_t n) {
+        return n == 0 ? nullptr : reinterpret_cast<T*>(Alloc::allocate(n * sizeof(T)));
+    }
+    static void deallocate(T* p) { Alloc::deallocate(p, sizeof(T)); }
+    static void deallocate(T* p, size_t n) {
+        if (n != 0)
+            Alloc::deallocate(p, n * sizeof(T));
+    }
+};
+
 }
 
 
@@ -20,19 +20,52 @@ namespace mystl
 #define DEQUE_MAP_INIT_SIZE 8
 #endif
 
-template <class T>
+// deque 缓存的空闲缓冲区个数上限， 缓冲区变空时先放入缓存， 下次需要新缓冲区时优先复用
+#ifndef DEQUE_SPARE_BLOCKS
+#define DEQUE_SPARE_BLOCKS 2
+#endif
+
+// clear() 后， 以及 map 一端用完需要重新定位节点时， 使用的节点数少于 map_size / DEQUE_MAP_SHRINK_RATIO 就自动缩小 map
+// 缩小后占用率约为一半， 不会在增长/收缩的边界上来回重新分配, 设为 0 关闭自动收缩
+// pop_front/pop_back, erase(first, last) 和 resize 本身不收缩 map， 存活元素的迭代器保持有效
+#ifndef DEQUE_MAP_SHRINK_RATIO
+#define DEQUE_MAP_SHRINK_RATIO 8
+#endif
+
+// 编译期计算: 不超过 n 的最大 2 的幂次， 以及 log2(n)
+constexpr size_t __deque_floor_pow2(size_t n) { return n < 2 ? n : 2 * __deque_floor_pow2(n / 2); }
+constexpr size_t __deque_log2(size_t n) { return n < 2 ? 0 : 1 + __deque_log2(n / 2); }
+
+// 默认缓冲区大小: 约 4096 字节， 向下取整到 2 的幂次， 至少 16 个元素
+constexpr size_t __deque_default_buf_size(size_t sz) {
+    return sz < 256 && __deque_floor_pow2(4096 / sz) > 16 ? __deque_floor_pow2(4096 / sz) : 16;
+}
+
+// 缓冲区大小， BufSiz 不为 0 时表示每个缓冲区容纳的元素个数， 为 0 时使用默认值
+// 缓冲区大小是 2 的幂次时， 迭代器的跨缓冲区运算使用移位代替乘除
+template <class T, size_t BufSiz = 0>
 struct deque_buf_size
 {
-    static constexpr size_t value = sizeof(T) < 256 ? 4096 / sizeof(T) : 16;
+    static constexpr size_t value = BufSiz != 0 ? BufSiz : __deque_default_buf_size(sizeof(T));
+    static constexpr bool   is_pow2 = (value & (value - 1)) == 0;
+    static constexpr size_t shift = __deque_log2(value);
 };
 
+template <class T, size_t BufSiz>
+constexpr size_t deque_buf_size<T, BufSiz>::value;
+template <class T, size_t BufSiz>
+constexpr bool deque_buf_size<T, BufSiz>::is_pow2;
+template <class T, size_t BufSiz>
+constexpr size_t deque_buf_size<T, BufSiz>::shift;
+
 // deque的迭代器设计
-template <class T, class Ref, class Ptr>
+template <class T, class Ref, class Ptr, size_t BufSiz = 0>
 struct __deque_iterator : public iterator<mystl::random_access_iterator_tag, T>
 {
-    typedef __deque_iterator<T, T&, T*>                        iterator;
-    typedef __deque_iterator<T, const T&, const T&>            const_iterator;
+    typedef __deque_iterator<T, T&, T*, BufSiz>                iterator;
+    typedef __deque_iterator<T, const T&, const T*, BufSiz>    const_iterator;
     typedef __deque_iterator                                   self;
+    typedef deque_buf_size<T, BufSiz>                          buf;
 
     typedef T           value_type;
     typedef Ptr         pointer;
@@ -42,7 +75,7 @@ struct __deque_iterator : public iterator<mystl::random_access_iterator_tag, T>
     typedef T*          value_pointer;
     typedef T**         map_pointer;
 
-    static const size_type buffer_size = deque_buf_size<T>::value;
+    static const size_type buffer_size = buf::value;
 
     // 迭代器所包含的成员函数 4个
     value_pointer cur; // 指向所在缓冲区的当前元素
@@ -83,8 +116,19 @@ struct __deque_iterator : public iterator<mystl::random_access_iterator_tag, T>
     reference operator*() const { return *cur; }
     pointer   operator->() const {return cur;}
 
+    // 节点数 <-> 元素数 的换算， 缓冲区大小是 2 的幂次时为移位
+    // 有符号数先转成无符号数再移位， 结果按补码转回
+    static difference_type nodes_to_elems(difference_type nodes) {
+        return buf::is_pow2
+               ? static_cast<difference_type>(static_cast<size_type>(nodes) << buf::shift)
+               : nodes * static_cast<difference_type>(buffer_size);
+    }
+    static size_type elems_to_nodes(size_type elems) {
+        return buf::is_pow2 ? elems >> buf::shift : elems / buffer_size;
+    }
+
     difference_type operator-(const self& x) const {
-        return static_cast<difference_type>(buffer_size * (node - x.node - 1)) + (cur - first) + (x.last - x.cur);
+        return nodes_to_elems(node - x.node - 1) + (cur - first) + (x.last - x.cur);
     }
 
     self& operator++() {
@@ -123,10 +167,10 @@ struct __deque_iterator : public iterator<mystl::random_access_iterator_tag, T>
             cur += n; // 仍在当前缓冲区
         } else { // 跳到其他缓冲区
             difference_type node_offset = offset > 0
-                    ? offset / static_cast<difference_type>(buffer_size)
-                    : -static_cast<difference_type>((-offset - 1) / buffer_size) -1;
+                    ? static_cast<difference_type>(elems_to_nodes(static_cast<size_type>(offset)))
+                    : -static_cast<difference_type>(elems_to_nodes(static_cast<size_type>(-offset - 1))) - 1;
             set_node(node + node_offset);
-            cur = first + (offset - node_offset * static_cast<difference_type>(buffer_size));
+            cur = first + (offset - nodes_to_elems(node_offset));
         }
         return *this;
     }
@@ -142,7 +186,7 @@ struct __deque_iterator : public iterator<mystl::random_access_iterator_tag, T>
 
     self operator-(difference_type n) const {
         self tmp = *this;
-        return *tmp -= n;
+        return tmp -= n;
     }
 
     reference operator[](difference_type n) const {
@@ -160,7 +204,8 @@ struct __deque_iterator : public iterator<mystl::random_access_iterator_tag, T>
 };
 
 // 模板类 deque
-template <class T>
+// 模板参数 BufSiz 为每个缓冲区的元素个数， 0 表示使用默认值(见 deque_buf_size)
+template <class T, size_t BufSiz = 0>
 class deque
 {
 public:
@@ -178,10 +223,10 @@ public:
     typedef pointer*                                 map_pointer;
     typedef const_pointer*                           const_map_pointer;
 
-    typedef __deque_iterator<T, T&, T*>              iterator;
-    typedef __deque_iterator<T, const T&, const T*>  const_iterator;
+    typedef __deque_iterator<T, T&, T*, BufSiz>              iterator;
+    typedef __deque_iterator<T, const T&, const T*, BufSiz>  const_iterator;
 
-    static const size_type buffer_size = deque_buf_size<T>::value;
+    static const size_type buffer_size = deque_buf_size<T, BufSiz>::value;
 
 private:
     // 4个数据表现一个deque
@@ -189,6 +234,9 @@ private:
     iterator  finish; // 指向最后一个节点
     map_pointer map_; // 指向map的指针，map中的每个元素是一个指针，指向一个缓冲区
     size_type map_size; // map内指针的个数
+    // 空闲缓冲区缓存， 避免队列稳定运行时在缓冲区边界反复分配/释放， 构造时全部置空， swap 整个数组交换
+    pointer   spare[DEQUE_SPARE_BLOCKS > 0 ? DEQUE_SPARE_BLOCKS : 1];
+    size_type num_spare;
 
 
 public:
@@ -206,9 +254,22 @@ public:
     bool empty() const {  return finish == start; } // = 已经重载
 
 private:
-    pointer allocate_node() { return data_allocator::allocate(buffer_size);}
+    // 优先从缓存中取缓冲区
+    pointer allocate_node() {
+        if (num_spare > 0)
+            return spare[--num_spare];
+        return data_allocator::allocate(buffer_size);
+    }
+    // 缓存未满时放入缓存， 否则释放
     void deallocate_node(pointer ptr) {
-        data_allocator::deallocate(ptr, buffer_size);
+        if (num_spare < DEQUE_SPARE_BLOCKS)
+            spare[num_spare++] = ptr;
+        else
+            data_allocator::deallocate(ptr, buffer_size);
+    }
+    void release_spare_blocks() {
+        while (num_spare > 0)
+            data_allocator::deallocate(spare[--num_spare], buffer_size);
     }
     // helper function, construct/destruct
     void create_map_and_nodes(size_type n); // 负责产生并安排好deque结构
@@ -217,19 +278,19 @@ private:
 
 public:
     // 构造，复制， 移动，析构
-    deque() : start(), finish(), map_(nullptr), map_size(0) {
+    deque() : start(), finish(), map_(nullptr), map_size(0), spare(), num_spare(0) {
         create_map_and_nodes(0);
     }
 
-    deque(size_type n, const value_type& x) : start(), finish(), map_(nullptr), map_size(0){
+    deque(size_type n, const value_type& x) : start(), finish(), map_(nullptr), map_size(0), spare(), num_spare(0){
         fill_initialize(n, x);
     }
 
-    explicit deque(size_type n) : start(), finish(), map_(nullptr), map_size(0) {
+    explicit deque(size_type n) : start(), finish(), map_(nullptr), map_size(0), spare(), num_spare(0) {
         fill_initialize(n, value_type());
     }
     // 拷贝构造
-    deque(const deque& x) : start(), finish(), map_(nullptr), map_size(0) {
+    deque(const deque& x) : start(), finish(), map_(nullptr), map_size(0), spare(), num_spare(0) {
         create_map_and_nodes(x.size());
         try {
             mystl::uninitialized_copy(x.begin(), x.end(), start);
@@ -238,12 +299,21 @@ public:
             throw;
         }
     }
-    // 移动构造
-    deque(deque&& rhs) = delete;
+    // 移动构造， 与同 libstdc++ 一样给 rhs 留下一个空的 map， 移动后的 rhs 仍可继续使用
+    deque(deque&& rhs) : start(), finish(), map_(nullptr), map_size(0), spare(), num_spare(0) {
+        create_map_and_nodes(0);
+        swap(rhs);
+    }
     // 拷贝赋值
     deque& operator=(const deque& rhs) = delete;
-    // 移动赋值
-    deque& operator=(deque&& rhs) = delete;
+    // 移动赋值， 自己的元素析构后把空壳交给 rhs
+    deque& operator=(deque&& rhs) {
+        if (this != &rhs) {
+            clear();
+            swap(rhs);
+        }
+        return *this;
+    }
 
     // 析构函数
     ~deque() {
@@ -253,26 +323,45 @@ public:
         }
     }
 
+    void swap(deque& rhs) noexcept {
+        mystl::swap(start, rhs.start);
+        mystl::swap(finish, rhs.finish);
+        mystl::swap(map_, rhs.map_);
+        mystl::swap(map_size, rhs.map_size);
+        for (size_type i = 0; i < DEQUE_SPARE_BLOCKS; ++i)
+            mystl::swap(spare[i], rhs.spare[i]);
+        mystl::swap(num_spare, rhs.num_spare);
+    }
+
 public:
-    // push_*, pop_*
-    void push_back(const value_type& t) {
+    // emplace_*, push_*, pop_*
+    // 在尾部就地构造元素
+    template <class... Args>
+    void emplace_back(Args&&... args) {
         if (finish.cur != finish.last - 1) { // 最后缓冲区还有至少两个位置
-            mystl::construct(finish.cur, t);
+            mystl::construct(finish.cur, mystl::forward<Args>(args)...);
             ++finish.cur;
         } else { // 最后缓冲区 只有一个位置
-            push_back_aux(t);
+            push_back_aux(mystl::forward<Args>(args)...);
         }
     }
 
-    void push_front(const value_type& t) {
+    // 在头部就地构造元素
+    template <class... Args>
+    void emplace_front(Args&&... args) {
         if (start.cur != start.first) { // 第一缓冲区有备用空间
-            mystl::construct(start.cur - 1, t);
+            mystl::construct(start.cur - 1, mystl::forward<Args>(args)...);
             --start.cur;
         } else { // 第一缓冲区已无备用空间
-            push_front_aux(t);
+            push_front_aux(mystl::forward<Args>(args)...);
         }
     }
 
+    void push_back(const value_type& t) { emplace_back(t); }
+    void push_back(value_type&& t) { emplace_back(mystl::move(t)); }
+    void push_front(const value_type& t) { emplace_front(t); }
+    void push_front(value_type&& t) { emplace_front(mystl::move(t)); }
+
     void pop_back() {
         if (finish.cur != finish.first) {
             // 最后缓冲区有一个(或更多)元素
@@ -300,48 +389,173 @@ public: // erase相关
         iterator next = pos;
         ++next;
         difference_type index = pos - start;
-        if (index < (size() >> 1)) {
-            mystl::copy_backward(start, pos, next);
+        if (index < static_cast<difference_type>(size() >> 1)) {
+            mystl::move_backward(start, pos, next);
             pop_front();
         } else {
-            mystl::copy(next, finish, pos);
+            mystl::move(next, finish, pos);
             pop_back();
         }
         return start + index;
     }
 
-    void erase(iterator first, iterator last);
+    iterator erase(iterator first, iterator last);
     void clear();
 
-    iterator insert_aux(iterator pos, const value_type& x);
-    iterator insert(iterator pos, const value_type& x) {
+    // 释放缓存的空闲缓冲区， 并把 map 缩小到刚好容纳现有节点
+    void shrink_to_fit() {
+        release_spare_blocks();
+        const size_type nodes_num = finish.node - start.node + 1;
+        const size_type new_map_size = mystl::max(static_cast<size_type>(DEQUE_MAP_INIT_SIZE), nodes_num + 2);
+        if (new_map_size < map_size)
+            reallocate_map_to(new_map_size);
+    }
+
+    // 占用的字节数: 对象本身 + map + 使用中和缓存的缓冲区
+    size_type memory_usage() const {
+        const size_type nodes_num = finish.node - start.node + 1 + num_spare;
+        return sizeof(*this) + map_size * sizeof(pointer) + nodes_num * buffer_size * sizeof(value_type);
+    }
+
+    // 在 pos 处就地构造元素
+    template <class... Args>
+    iterator emplace(iterator pos, Args&&... args) {
         if (pos.cur == start.cur) { // 插入的是前方
-            push_front(x);
+            emplace_front(mystl::forward<Args>(args)...);
             return start;
         } else if (pos.cur == finish.cur) { // 插入的是back
-            push_back(x);
+            emplace_back(mystl::forward<Args>(args)...);
             iterator tmp = finish;
             --tmp;
             return tmp;
         } else {
-            return insert_aux(pos, x);
+            return insert_aux(pos, mystl::forward<Args>(args)...);
         }
+    }
+
+    iterator insert(iterator pos, const value_type& x) { return emplace(pos, x); }
+    iterator insert(iterator pos, value_type&& x) { return emplace(pos, mystl::move(x)); }
 
+public: // 区间的批量操作， map 只调整一次， 缓冲区一次配置好， 再逐个缓冲区连续构造
+    // 把 [first, last) 追加到尾部
+    template <class InputIter>
+    void append(InputIter first, InputIter last) {
+        range_append(first, last, mystl::iterator_category(first));
     }
 
+    // 把 [first, last) 插入到头部， 保持区间内的顺序
+    template <class InputIter>
+    void prepend(InputIter first, InputIter last) {
+        range_prepend(first, last, mystl::iterator_category(first));
+    }
+
+    // 在 pos 处插入 [first, last)
+    template <class InputIter>
+    void insert(iterator pos, InputIter first, InputIter last) {
+        range_insert(pos, first, last, mystl::iterator_category(first));
+    }
+
+    void resize(size_type new_size, const value_type& x) {
+        const size_type len = size();
+        if (new_size < len)
+            erase(start + static_cast<difference_type>(new_size), finish);
+        else
+            fill_append(new_size - len, x);
+    }
+    void resize(size_type new_size) { resize(new_size, value_type()); }
+
+private:
+    // 在尾部/头部预留 n 个元素的空间， 返回新的 finish/start
+    iterator reserve_elements_at_back(size_type n) {
+        const size_type vacancies = finish.last - finish.cur - 1;
+        if (n > vacancies)
+            new_elements_at_back(n - vacancies);
+        return finish + static_cast<difference_type>(n);
+    }
+    iterator reserve_elements_at_front(size_type n) {
+        const size_type vacancies = start.cur - start.first;
+        if (n > vacancies)
+            new_elements_at_front(n - vacancies);
+        return start - static_cast<difference_type>(n);
+    }
+    void new_elements_at_back(size_type new_elems);
+    void new_elements_at_front(size_type new_elems);
+    // 构造失败时释放预留的缓冲区
+    void destroy_nodes_at_back(iterator new_finish) {
+        for (map_pointer n = finish.node + 1; n <= new_finish.node; ++n)
+            deallocate_node(*n);
+    }
+    void destroy_nodes_at_front(iterator new_start) {
+        for (map_pointer n = new_start.node; n < start.node; ++n)
+            deallocate_node(*n);
+    }
+
+    // 在从 pos 开始的已预留空间上构造 n 个元素， 每个缓冲区调用一次指针版本的 uninitialized_*
+    template <class ForwardIter>
+    iterator copy_to_blocks(ForwardIter first, size_type n, iterator pos);
+    iterator fill_to_blocks(size_type n, iterator pos, const value_type& x);
+
+    template <class InputIter>
+    void range_append(InputIter first, InputIter last, mystl::input_iterator_tag) {
+        for (; first != last; ++first)
+            emplace_back(*first);
+    }
+    template <class ForwardIter>
+    void range_append(ForwardIter first, ForwardIter last, mystl::forward_iterator_tag);
+
+    template <class InputIter>
+    void range_prepend(InputIter first, InputIter last, mystl::input_iterator_tag) {
+        insert(start, first, last);
+    }
+    template <class ForwardIter>
+    void range_prepend(ForwardIter first, ForwardIter last, mystl::forward_iterator_tag);
 
+    template <class InputIter>
+    void range_insert(iterator pos, InputIter first, InputIter last, mystl::input_iterator_tag) {
+        // 单向迭代器无法预先得知长度， 逐个插入
+        for (; first != last; ++first, ++pos)
+            pos = emplace(pos, *first);
+    }
+    template <class ForwardIter>
+    void range_insert(iterator pos, ForwardIter first, ForwardIter last, mystl::forward_iterator_tag);
 
+    void fill_append(size_type n, const value_type& x);
 
 private:
+    template <class... Args>
+    iterator insert_aux(iterator pos, Args&&... args);
     // 最后缓冲区只剩一个备用元素空间时会被调用
-    void push_back_aux(const value_type& x);
+    template <class... Args>
+    void push_back_aux(Args&&... args);
     // 第一个缓冲区没有任何备用元素空间时会被调用
-    void push_front_aux(const value_type& x);
+    template <class... Args>
+    void push_front_aux(Args&&... args);
     void pop_back_aux();
     void pop_front_aux();
 private:
     // helper function and internal push_*, pop_*
     void reallocate_map(size_type nodes_to_add, bool add_at_front);
+    // 换一块大小为 new_map_size 的 map, 节点放在中间， 并在前面或后面留出 nodes_to_add 个空位
+    void reallocate_map_to(size_type new_map_size, size_type nodes_to_add = 0, bool add_at_front = false);
+    // 放 nodes_num 个节点时 map 应该缩小到的大小， 占用率不低于阈值时返回 0
+    size_type shrunk_map_size(size_type nodes_num) const {
+        if (DEQUE_MAP_SHRINK_RATIO == 0 || map_size <= DEQUE_MAP_INIT_SIZE)
+            return 0;
+        if (nodes_num * DEQUE_MAP_SHRINK_RATIO >= map_size)
+            return 0;
+        return mystl::max(static_cast<size_type>(DEQUE_MAP_INIT_SIZE), 2 * nodes_num + 2);
+    }
+    // 节点占用率过低时缩小 map
+    void shrink_map_if_sparse() {
+        const size_type new_map_size = shrunk_map_size(finish.node - start.node + 1);
+        if (new_map_size == 0)
+            return;
+        try {
+            reallocate_map_to(new_map_size);
+        } catch (...) {
+            // 分配失败时原来的 map 和节点都没有改动， 只是少回收一些内存， deque 仍然完整可用
+        }
+    }
     // 在后面加一个缓冲区
     void reserve_map_at_back(size_type nodes_to_add = 1) {
         if (nodes_to_add + 1 > map_size - (finish.node - map_))
@@ -356,8 +570,8 @@ private:
 
 };
 
-template<class T>
-void deque<T>::create_map_and_nodes(size_type n) {
+template <class T, size_t BufSiz>
+void deque<T, BufSiz>::create_map_and_nodes(size_type n) {
     // 需要节点数
     size_type num_nodes = n / buffer_size + 1;
     // map 管理节点数， 最少8个，最多 需要节点数 + 2
@@ -372,8 +586,9 @@ void deque<T>::create_map_and_nodes(size_type n) {
         for (cur = nstart; cur <= nfinish; ++cur)
             *cur = allocate_node();
     } catch (...) {
-        for (map_pointer n = cur; n < cur; ++n)
+        for (map_pointer n = nstart; n < cur; ++n)
             deallocate_node(*n);
+        release_spare_blocks();
         map_allocator::deallocate(map_, map_size);
         throw;
     }
@@ -383,15 +598,16 @@ void deque<T>::create_map_and_nodes(size_type n) {
     finish.cur = finish.first + n % buffer_size;
 }
 
-template <class T>
-void deque<T>::destroy_map_and_nodes() {
+template <class T, size_t BufSiz>
+void deque<T, BufSiz>::destroy_map_and_nodes() {
     for (map_pointer cur = start.node; cur <= finish.node; ++cur)
-        deallocate_node(*cur);
+        data_allocator::deallocate(*cur, buffer_size);
+    release_spare_blocks();
     map_allocator::deallocate(map_, map_size);
 }
 
-template <class T>
-void deque<T>::fill_initialize(size_type n, const value_type &value) {
+template <class T, size_t BufSiz>
+void deque<T, BufSiz>::fill_initialize(size_type n, const value_type &value) {
     create_map_and_nodes(n);
     map_pointer cur;
     try {
@@ -406,13 +622,14 @@ void deque<T>::fill_initialize(size_type n, const value_type &value) {
     }
 }
 
-template<class T>
-void deque<T>::push_back_aux(const value_type &x) {
-    value_type x_copy = x;
+// 重新分配 map 不会搬移元素， args 引用容器内的元素时依然有效， 不需要先复制一份
+template <class T, size_t BufSiz>
+template <class... Args>
+void deque<T, BufSiz>::push_back_aux(Args&&... args) {
     reserve_map_at_back();
     *(finish.node + 1) = allocate_node();
     try {
-        mystl::construct(finish.cur,x_copy);
+        mystl::construct(finish.cur, mystl::forward<Args>(args)...);
         finish.set_node(finish.node + 1);
         finish.cur = finish.first;
     } catch (...) {
@@ -421,15 +638,15 @@ void deque<T>::push_back_aux(const value_type &x) {
     }
 }
 
-template <class T>
-void deque<T>::push_front_aux(const value_type &x) {
-    value_type x_copy = x;
+template <class T, size_t BufSiz>
+template <class... Args>
+void deque<T, BufSiz>::push_front_aux(Args&&... args) {
     reserve_map_at_front();
     *(start.node - 1) = allocate_node();
     try {
         start.set_node(start.node - 1);
         start.cur = start.last - 1;
-        mystl::construct(start.cur, x_copy);
+        mystl::construct(start.cur, mystl::forward<Args>(args)...);
     } catch (...) {
         start.set_node(start.node + 1);
         start.cur = start.first;
@@ -438,17 +655,27 @@ void deque<T>::push_front_aux(const value_type &x) {
     }
 }
 
-template <class T>
-void deque<T>::reallocate_map(size_type nodes_to_add, bool add_at_front) {
+template <class T, size_t BufSiz>
+void deque<T, BufSiz>::reallocate_map(size_type nodes_to_add, bool add_at_front) {
     size_type old_nodes_num = finish.node - start.node + 1;
     size_type new_nodes_num = old_nodes_num + nodes_to_add;
     map_pointer new_nstart;
     if (map_size > 2 * new_nodes_num) {
+        // 重新定位节点已经让所有迭代器失效， 占用率过低时顺便换一块小的 map
+        const size_type shrunk = shrunk_map_size(new_nodes_num);
+        if (shrunk != 0) {
+            try {
+                reallocate_map_to(shrunk, nodes_to_add, add_at_front);
+                return;
+            } catch (...) {
+                // 分配失败时原来的 map 没有改动， 它的空位足够， 下面原地重新居中即可
+            }
+        }
         new_nstart = map_ + (map_size - new_nodes_num) / 2 + (add_at_front ? nodes_to_add : 0);
         if (new_nstart < start.node)
             mystl::copy(start.node, finish.node + 1, new_nstart);
         else
-            mystl::copy_backward(start.node, finish.node + 1, new_nstart);
+            mystl::copy_backward(start.node, finish.node + 1, new_nstart + old_nodes_num);
     } else {
         size_type new_map_size = map_size + mystl::max(map_size, new_nodes_num) + 2;
         // 配置一块新空间
@@ -465,8 +692,211 @@ void deque<T>::reallocate_map(size_type nodes_to_add, bool add_at_front) {
     finish.set_node(new_nstart + old_nodes_num - 1);
 }
 
-template <class T>
-void deque<T>::pop_back_aux() {
+template <class T, size_t BufSiz>
+void deque<T, BufSiz>::reallocate_map_to(size_type new_map_size, size_type nodes_to_add, bool add_at_front) {
+    const size_type nodes_num = finish.node - start.node + 1;
+    map_pointer new_map = map_allocator::allocate(new_map_size);
+    map_pointer new_nstart = new_map + (new_map_size - nodes_num - nodes_to_add) / 2 + (add_at_front ? nodes_to_add : 0);
+    mystl::copy(start.node, finish.node + 1, new_nstart);
+    map_allocator::deallocate(map_, map_size);
+    map_ = new_map;
+    map_size = new_map_size;
+    start.set_node(new_nstart);
+    finish.set_node(new_nstart + nodes_num - 1);
+}
+
+template <class T, size_t BufSiz>
+void deque<T, BufSiz>::new_elements_at_back(size_type new_elems) {
+    const size_type new_nodes = (new_elems + buffer_size - 1) / buffer_size;
+    reserve_map_at_back(new_nodes);
+    size_type i;
+    try {
+        for (i = 1; i <= new_nodes; ++i)
+            *(finish.node + i) = allocate_node();
+    } catch (...) {
+        for (size_type j = 1; j < i; ++j)
+            deallocate_node(*(finish.node + j));
+        throw;
+    }
+}
+
+template <class T, size_t BufSiz>
+void deque<T, BufSiz>::new_elements_at_front(size_type new_elems) {
+    const size_type new_nodes = (new_elems + buffer_size - 1) / buffer_size;
+    reserve_map_at_front(new_nodes);
+    size_type i;
+    try {
+        for (i = 1; i <= new_nodes; ++i)
+            *(start.node - i) = allocate_node();
+    } catch (...) {
+        for (size_type j = 1; j < i; ++j)
+            deallocate_node(*(start.node - j));
+        throw;
+    }
+}
+
+template <class T, size_t BufSiz>
+template <class ForwardIter>
+typename deque<T, BufSiz>::iterator
+deque<T, BufSiz>::copy_to_blocks(ForwardIter first, size_type n, iterator pos) {
+    iterator cur = pos;
+    try {
+        while (n > 0) {
+            const size_type room = cur.last - cur.cur;
+            const size_type len = n < room ? n : room;
+            ForwardIter mid = first;
+            mystl::advance(mid, len);
+            mystl::uninitialized_copy(first, mid, cur.cur);
+            first = mid;
+            cur += static_cast<difference_type>(len);
+            n -= len;
+        }
+    } catch (...) {
+        mystl::destroy(pos, cur);
+        throw;
+    }
+    return cur;
+}
+
+template <class T, size_t BufSiz>
+typename deque<T, BufSiz>::iterator
+deque<T, BufSiz>::fill_to_blocks(size_type n, iterator pos, const value_type& x) {
+    iterator cur = pos;
+    try {
+        while (n > 0) {
+            const size_type room = cur.last - cur.cur;
+            const size_type len = n < room ? n : room;
+            mystl::uninitialized_fill_n(cur.cur, len, x);
+            cur += static_cast<difference_type>(len);
+            n -= len;
+        }
+    } catch (...) {
+        mystl::destroy(pos, cur);
+        throw;
+    }
+    return cur;
+}
+
+template <class T, size_t BufSiz>
+template <class ForwardIter>
+void deque<T, BufSiz>::range_append(ForwardIter first, ForwardIter last, mystl::forward_iterator_tag) {
+    const size_type n = mystl::distance(first, last);
+    iterator new_finish = reserve_elements_at_back(n);
+    try {
+        copy_to_blocks(first, n, finish);
+    } catch (...) {
+        destroy_nodes_at_back(new_finish);
+        throw;
+    }
+    finish = new_finish;
+}
+
+template <class T, size_t BufSiz>
+template <class ForwardIter>
+void deque<T, BufSiz>::range_prepend(ForwardIter first, ForwardIter last, mystl::forward_iterator_tag) {
+    const size_type n = mystl::distance(first, last);
+    iterator new_start = reserve_elements_at_front(n);
+    try {
+        copy_to_blocks(first, n, new_start);
+    } catch (...) {
+        destroy_nodes_at_front(new_start);
+        throw;
+    }
+    start = new_start;
+}
+
+template <class T, size_t BufSiz>
+void deque<T, BufSiz>::fill_append(size_type n, const value_type& x) {
+    iterator new_finish = reserve_elements_at_back(n);
+    try {
+        fill_to_blocks(n, finish, x);
+    } catch (...) {
+        destroy_nodes_at_back(new_finish);
+        throw;
+    }
+    finish = new_finish;
+}
+
+// 参考 SGI 的 insert_aux(pos, first, last, n): 在插入点前后较短的一侧预留空间， 平移较少的元素
+template <class T, size_t BufSiz>
+template <class ForwardIter>
+void deque<T, BufSiz>::range_insert(iterator pos, ForwardIter first, ForwardIter last, mystl::forward_iterator_tag) {
+    if (pos.cur == start.cur) {
+        range_prepend(first, last, mystl::forward_iterator_tag());
+        return;
+    }
+    if (pos.cur == finish.cur) {
+        range_append(first, last, mystl::forward_iterator_tag());
+        return;
+    }
+    const difference_type n = mystl::distance(first, last);
+    if (n == 0) return;
+    const difference_type elems_before = pos - start;
+    const difference_type length = static_cast<difference_type>(size());
+    if (elems_before < length / 2) {
+        iterator new_start = reserve_elements_at_front(n);
+        iterator old_start = start;
+        pos = start + elems_before;
+        try {
+            if (elems_before >= n) {
+                // 前 n 个元素搬到预留空间， 其余前方元素整体前移， 再把区间拷贝到空出的位置
+                iterator start_n = start + n;
+                mystl::uninitialized_move(start, start_n, new_start);
+                start = new_start;
+                mystl::move(start_n, pos, old_start);
+                mystl::copy(first, last, pos - n);
+            } else {
+                // 前方元素全部搬到预留空间， 区间前一部分也构造在预留空间上
+                ForwardIter mid = first;
+                mystl::advance(mid, n - elems_before);
+                iterator cur = mystl::uninitialized_move(start, pos, new_start);
+                try {
+                    copy_to_blocks(first, n - elems_before, cur);
+                } catch (...) {
+                    mystl::destroy(new_start, cur);
+                    throw;
+                }
+                start = new_start;
+                mystl::copy(mid, last, old_start);
+            }
+        } catch (...) {
+            destroy_nodes_at_front(new_start);
+            throw;
+        }
+    } else {
+        iterator new_finish = reserve_elements_at_back(n);
+        iterator old_finish = finish;
+        const difference_type elems_after = length - elems_before;
+        pos = finish - elems_after;
+        try {
+            if (elems_after > n) {
+                iterator finish_n = finish - n;
+                mystl::uninitialized_move(finish_n, finish, finish);
+                finish = new_finish;
+                mystl::move_backward(pos, finish_n, old_finish);
+                mystl::copy(first, last, pos);
+            } else {
+                ForwardIter mid = first;
+                mystl::advance(mid, elems_after);
+                iterator cur = copy_to_blocks(mid, n - elems_after, finish);
+                try {
+                    mystl::uninitialized_move(pos, finish, cur);
+                } catch (...) {
+                    mystl::destroy(finish, cur);
+                    throw;
+                }
+                finish = new_finish;
+                mystl::copy(first, mid, pos);
+            }
+        } catch (...) {
+            destroy_nodes_at_back(new_finish);
+            throw;
+        }
+    }
+}
+
+template <class T, size_t BufSiz>
+void deque<T, BufSiz>::pop_back_aux() {
     // 释放最后一个分区
     deallocate_node(finish.first);
     finish.set_node(finish.node - 1);
@@ -474,71 +904,78 @@ void deque<T>::pop_back_aux() {
     mystl::destroy(finish.cur);
 }
 
-template <class T>
-void deque<T>::pop_front_aux() {
+template <class T, size_t BufSiz>
+void deque<T, BufSiz>::pop_front_aux() {
     mystl::destroy(start.cur);
     deallocate_node(start.first);
     start.set_node(start.node + 1);
     start.cur = start.first;
 }
 
-template <class T>
-void deque<T>::clear() {
+template <class T, size_t BufSiz>
+void deque<T, BufSiz>::clear() {
     // 以下针对头尾以外的每一个缓冲区(一定是饱满的)
     for (map_pointer x = start.node + 1; x < finish.node; ++x) {
         mystl::destroy(*x, *x + buffer_size);
-        data_allocator::deallocate(*x, buffer_size);
+        deallocate_node(*x);
     }
     if (start.node != finish.node) { // 头 尾 不在一个分区
         mystl::destroy(start.cur, start.last);
         mystl::destroy(finish.first, finish.cur);
         // 以下释放尾部缓冲区，头缓冲区保留
-        data_allocator::deallocate(finish.first, buffer_size);
+        deallocate_node(finish.first);
     } else {
         mystl::destroy(start.cur,finish.cur);
         // 注意不释放空间
     }
     finish = start;
-
+    shrink_map_if_sparse();
 }
 
-template <class T>
-void deque<T>::erase(iterator first, iterator last) {
+template <class T, size_t BufSiz>
+typename deque<T, BufSiz>::iterator
+deque<T, BufSiz>::erase(iterator first, iterator last) {
     if (first == start && last == finish) {
         // 清除 整个区间
         clear();
         return finish;
+    } else if (first == last) {
+        // 空区间， 不能进入下面的平移， 否则元素会自我移动赋值
+        return first;
     } else {
         difference_type n = last - first; // 清除区间的长度
         difference_type elems_before = first - start; // 清除区间前方的元素个数
-        if (elems_before < (size() - n) /2 ) {
-            // 前方元素少，向后copy
-            mystl::copy_backward(start, first, last);
+        if (elems_before < static_cast<difference_type>(size() - n) / 2) {
+            // 前方元素少， 向后移动
+            mystl::move_backward(start, first, last);
             iterator new_start = start + n;
+            mystl::destroy(start, new_start);
             // 释放缓冲区
             for (map_pointer x = start.node; x < new_start.node; ++x)
-                data_allocator::deallocate(*x, buffer_size);
+                deallocate_node(*x);
             start = new_start;
-        } else { // 后方元素少
-            mystl::copy(last,first,first);
+        } else { // 后方元素少， 向前移动
+            mystl::move(last, finish, first);
             iterator new_finish = finish - n;
             mystl::destroy(new_finish, finish);
             for (map_pointer x = new_finish.node + 1; x <= finish.node; ++ x)
-                data_allocator::deallocate(*x, buffer_size);
+                deallocate_node(*x);
             finish = new_finish;
         }
         return start + elems_before;
     }
 }
 
-template <class T>
-typename deque<T>::iterator
-deque<T>::insert_aux(iterator pos, const value_type &x) {
+// 元素整体平移使用 move, args 可能引用容器内的元素， 先构造出新元素
+template <class T, size_t BufSiz>
+template <class... Args>
+typename deque<T, BufSiz>::iterator
+deque<T, BufSiz>::insert_aux(iterator pos, Args&&... args) {
     difference_type index = pos - start;// 插入点之前的元素个数
-    value_type x_copy = x;
-    if (index < size() / 2) {
+    value_type x_copy(mystl::forward<Args>(args)...);
+    if (index < static_cast<difference_type>(size() / 2)) {
         // 移动前方的元素
-        push_front(front());
+        push_front(mystl::move(front()));
         iterator front1 = start;
         ++front1;
         iterator front2 = front1;
@@ -546,17 +983,17 @@ deque<T>::insert_aux(iterator pos, const value_type &x) {
         pos = start + index;
         iterator pos1 = pos;
         ++pos1;
-        mystl::copy(front2, pos1, front1);
+        mystl::move(front2, pos1, front1);
     } else {
-        push_back(back());
+        push_back(mystl::move(back()));
         iterator back1 = finish;
         --back1;
         iterator back2 = back1;
         --back2;
         pos = start + index;
-        mystl::copy_backward(pos, back2, back1);
+        mystl::move_backward(pos, back2, back1);
     }
-    *pos = x_copy;
+    *pos = mystl::move(x_copy);
     return pos;
 }
 
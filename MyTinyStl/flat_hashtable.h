@@ -0,0 +1,577 @@
+#ifndef FJXTINYSTL_FLAT_HASHTABLE_H
+#define FJXTINYSTL_FLAT_HASHTABLE_H
+
+//
+// Created by fengjiaxin on 2023/4/24.
+// 开放寻址的 hash 表(Swiss table)， 接口和 hashtable 相同， 可以作为 hash_map/hash_set 的底层
+// 1. 元素直接存放在槽数组里， 不为每个元素单独分配节点
+// 2. 每个槽对应 1 个控制字节: 空， 已删除， 或者是 hash 值的低 7 位(H2)
+// 3. 16 个槽为一组， 查找时一次比较一整组的控制字节(SSE2)， 只对 H2 相同的槽比较 key
+// 4. 组按三角数序列探测(第 i 次跳 i 组)， 组数是 2 的幂次， 可以遍历所有组
+// 5. 最大负载 7/8， 没有 SSE2 时使用逐字节比较的版本
+//
+
+#include <stdint.h>
+#include <string.h>
+#include <utility>
+#include "iterator.h"
+#include "allocator.h"
+#include "construct.h"
+#include "util.h"
+#include "hash_fun.h"
+#include "hashtable_stats.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace mystl
+{
+
+// 控制字节: 满的槽为 0xxxxxxx(H2)， 其余最高位为 1
+typedef signed char flat_ctrl_t;
+static const flat_ctrl_t flat_ctrl_empty = -128;    // 10000000
+static const flat_ctrl_t flat_ctrl_deleted = -2;    // 11111110
+static const flat_ctrl_t flat_ctrl_sentinel = -1;   // 11111111, 放在控制字节数组末尾， 迭代器遇到它停下
+
+static const size_t flat_group_width = 16;
+
+// 打散 hash 值， 整数的 hash 是原值， 不打散的话连续的 key 会挤在同一组
+// MurmurHash3 的 fmix64， 只做一轮乘法时连续整数的低位仍然成簇， 探测长度明显偏长
+inline size_t __flat_mix(size_t h) {
+    uint64_t x = static_cast<uint64_t>(h);
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return static_cast<size_t>(x);
+}
+
+// 最低位 1 的位置， mask 不为 0
+inline size_t __flat_lowest_bit(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_ctz(mask));
+#else
+    size_t res = 0;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        ++res;
+    }
+    return res;
+#endif
+}
+
+// 一组 16 个控制字节， 各个 match 返回位掩码， 第 i 位表示第 i 个槽
+struct __flat_group {
+#ifdef __SSE2__
+    __m128i ctrl;
+
+    explicit __flat_group(const flat_ctrl_t* p) : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+    uint32_t match(flat_ctrl_t h2) const {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+    }
+    uint32_t match_empty() const { return match(flat_ctrl_empty); }
+    // 空或已删除: 控制字节 < sentinel
+    uint32_t match_empty_or_deleted() const {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(flat_ctrl_sentinel), ctrl)));
+    }
+#else
+    const flat_ctrl_t* ctrl;
+
+    explicit __flat_group(const flat_ctrl_t* p) : ctrl(p) {}
+
+    uint32_t match(flat_ctrl_t h2) const {
+        uint32_t res = 0;
+        for (size_t i = 0; i < flat_group_width; ++i)
+            res |= static_cast<uint32_t>(ctrl[i] == h2) << i;
+        return res;
+    }
+    uint32_t match_empty() const { return match(flat_ctrl_empty); }
+    uint32_t match_empty_or_deleted() const {
+        uint32_t res = 0;
+        for (size_t i = 0; i < flat_group_width; ++i)
+            res |= static_cast<uint32_t>(ctrl[i] < flat_ctrl_sentinel) << i;
+        return res;
+    }
+#endif
+};
+
+// 探测序列， 以组为单位， 第 i 次跳过 i 组
+struct __flat_probe {
+    size_t mask;   // 组数 - 1
+    size_t group;  // 当前组号
+    size_t index;  // 已探测的次数
+
+    __flat_probe(size_t h1, size_t m) : mask(m), group(h1 & m), index(0) {}
+
+    size_t offset() const { return group * flat_group_width; }
+    void next() {
+        ++index;
+        group = (group + index) & mask;
+    }
+};
+
+// 迭代器， 同时指向控制字节和槽
+template <class Value, class Ref, class Ptr>
+struct flat_hashtable_iterator : public mystl::iterator<mystl::forward_iterator_tag, Value> {
+    typedef flat_hashtable_iterator<Value, Value&, Value*>              iterator;
+    typedef flat_hashtable_iterator<Value, const Value&, const Value*>  const_iterator;
+    typedef flat_hashtable_iterator                                     self;
+
+    typedef Value       value_type;
+    typedef Ref         reference;
+    typedef Ptr         pointer;
+    typedef ptrdiff_t   difference_type;
+    typedef size_t      size_type;
+
+    const flat_ctrl_t* ctrl;
+    Value* slot;
+
+    flat_hashtable_iterator() : ctrl(nullptr), slot(nullptr) {}
+    flat_hashtable_iterator(const flat_ctrl_t* c, Value* s) : ctrl(c), slot(s) {}
+    flat_hashtable_iterator(const iterator& it) : ctrl(it.ctrl), slot(it.slot) {}
+    self& operator=(const self&) = default;
+
+    reference operator*() const { return *slot; }
+    pointer operator->() const { return slot; }
+
+    bool operator==(const self& it) const { return ctrl == it.ctrl; }
+    bool operator!=(const self& it) const { return ctrl != it.ctrl; }
+
+    self& operator++() {
+        ++ctrl;
+        ++slot;
+        skip_empty_or_deleted();
+        return *this;
+    }
+    self operator++(int) {
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    // 跳到下一个满的槽或者末尾的 sentinel
+    void skip_empty_or_deleted() {
+        while (*ctrl < flat_ctrl_sentinel) {
+            ++ctrl;
+            ++slot;
+        }
+    }
+};
+
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+class flat_hashtable {
+public:
+    typedef Key  key_type;
+    typedef Value value_type;
+    typedef HashFcn hasher;
+    typedef EqualKey key_equal;
+
+    typedef size_t  size_type;
+    typedef ptrdiff_t difference_type;
+    typedef value_type* pointer;
+    typedef const value_type* const_pointer;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+
+    typedef flat_hashtable_iterator<Value, Value&, Value*>              iterator;
+    typedef flat_hashtable_iterator<Value, const Value&, const Value*>  const_iterator;
+
+    hasher hash_func() const { return hash; }
+    key_equal key_eq() const { return equals; }
+
+private:
+    typedef mystl::allocator<Value>       slot_allocator;
+    typedef mystl::allocator<flat_ctrl_t> ctrl_allocator;
+
+    hasher  hash;
+    key_equal equals;
+    ExtractKey get_key;
+    flat_ctrl_t* ctrl;      // capacity + 1 个控制字节， 最后一个是 sentinel
+    value_type*  slots;     // capacity 个槽
+    size_type capacity;     // 槽数， 2 的幂次， 至少一组
+    size_type num_elements;
+    size_type growth_left;  // 还能占用多少个空槽， 占用已删除的槽不消耗
+    hashtable_resize_callback resize_callback; // rehash 后调用， 默认为空
+
+public:
+    // 构造， 复制， 析构
+    flat_hashtable(size_type n, const HashFcn& hf, const EqualKey& eql)
+        : hash(hf), equals(eql), get_key(ExtractKey()), ctrl(nullptr), slots(nullptr),
+          capacity(0), num_elements(0), growth_left(0), resize_callback(nullptr) {
+        initialize_slots(capacity_for(n));
+    }
+
+    flat_hashtable(const flat_hashtable& ht)
+        : hash(ht.hash), equals(ht.equals), get_key(ht.get_key), ctrl(nullptr), slots(nullptr),
+          capacity(0), num_elements(0), growth_left(0), resize_callback(ht.resize_callback) {
+        copy_from(ht);
+    }
+
+    flat_hashtable& operator=(const flat_hashtable& ht) {
+        if (&ht != this) {
+            flat_hashtable tmp(ht);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    ~flat_hashtable() {
+        destroy_slots();
+    }
+
+public:
+    // 和容量相关的查询
+    size_type size() const { return num_elements; }
+    bool empty() const { return num_elements == 0; }
+    void swap(flat_hashtable& ht) {
+        mystl::swap(hash, ht.hash);
+        mystl::swap(equals, ht.equals);
+        mystl::swap(get_key, ht.get_key);
+        mystl::swap(ctrl, ht.ctrl);
+        mystl::swap(slots, ht.slots);
+        mystl::swap(capacity, ht.capacity);
+        mystl::swap(num_elements, ht.num_elements);
+        mystl::swap(growth_left, ht.growth_left);
+        mystl::swap(resize_callback, ht.resize_callback);
+    }
+
+    // 查询边界
+    iterator begin() {
+        iterator it(ctrl, slots);
+        it.skip_empty_or_deleted();
+        return it;
+    }
+    const_iterator begin() const {
+        const_iterator it(ctrl, slots);
+        it.skip_empty_or_deleted();
+        return it;
+    }
+    iterator end() { return iterator(ctrl + capacity, slots + capacity); }
+    const_iterator end() const { return const_iterator(ctrl + capacity, slots + capacity); }
+
+public:
+    // 和 bucket 相关的查询， 每个槽看作一个 bucket
+    size_type bucket_count() const { return capacity; }
+    size_type max_bucket_count() const { return static_cast<size_type>(1) << (sizeof(size_type) * 8 - 2); }
+    size_type elems_in_bucket(size_type bucket) const { return ctrl[bucket] >= 0 ? 1 : 0; }
+
+    // 插入元素， 不允许重复
+    std::pair<iterator, bool> insert_unique(const value_type& obj) {
+        return insert_unique_noresize(obj);
+    }
+    // 插入元素， 允许重复
+    iterator insert_equal(const value_type& obj) {
+        return insert_equal_noresize(obj);
+    }
+
+    // 开放寻址没有空槽时必须扩容， 所以 noresize 版本在负载达到 7/8 时同样会扩容
+    std::pair<iterator, bool> insert_unique_noresize(const value_type& obj) {
+        const size_type h = hash_of(get_key(obj));
+        const size_type i = find_index(get_key(obj), h);
+        if (i != capacity)
+            return std::pair<iterator, bool>(iterator_at(i), false);
+        return std::pair<iterator, bool>(iterator_at(insert_at(h, obj)), true);
+    }
+    iterator insert_equal_noresize(const value_type& obj) {
+        return iterator_at(insert_at(hash_of(get_key(obj)), obj));
+    }
+
+    reference find_or_insert(const value_type& obj) {
+        return *insert_unique_noresize(obj).first;
+    }
+
+    // 先按 key 查找， 找不到时才用 args 在槽里构造元素
+    template <class... Args>
+    std::pair<iterator, bool> emplace_unique_key(const key_type& key, Args&&... args) {
+        const size_type h = hash_of(key);
+        const size_type i = find_index(key, h);
+        if (i != capacity)
+            return std::pair<iterator, bool>(iterator_at(i), false);
+        return std::pair<iterator, bool>(iterator_at(insert_at(h, mystl::forward<Args>(args)...)), true);
+    }
+
+    // 先在栈上构造出元素才能得到 key， 插入时再移动进槽
+    template <class... Args>
+    std::pair<iterator, bool> emplace_unique(Args&&... args) {
+        value_type x(mystl::forward<Args>(args)...);
+        return emplace_unique_key(get_key(x), mystl::move(x));
+    }
+
+    iterator find(const key_type& key) { return find_key(key); }
+    const_iterator find(const key_type& key) const { return find_key(key); }
+    size_type count(const key_type& key) const { return count_key(key); }
+    size_type erase(const key_type& key) { return erase_key(key); }
+
+    // 异构查找: HashFcn 和 EqualKey 都带有 is_transparent 时， key 可以是任何能和 key_type 一起 hash/比较的类型
+    template <class K, class H = HashFcn, class E = EqualKey>
+    typename __if_transparent<H, E, iterator>::type find(const K& key) { return find_key(key); }
+    template <class K, class H = HashFcn, class E = EqualKey>
+    typename __if_transparent<H, E, const_iterator>::type find(const K& key) const { return find_key(key); }
+    template <class K, class H = HashFcn, class E = EqualKey>
+    typename __if_transparent<H, E, size_type>::type count(const K& key) const { return count_key(key); }
+    template <class K, class H = HashFcn, class E = EqualKey>
+    typename __if_transparent<H, E, size_type>::type erase(const K& key) { return erase_key(key); }
+
+    void erase(const iterator& it) {
+        if (it != end())
+            erase_at(static_cast<size_type>(it.slot - slots));
+    }
+
+    // 析构所有元素， 保留槽数组
+    void clear() {
+        for (size_type i = 0; i < capacity; ++i) {
+            if (ctrl[i] >= 0)
+                mystl::destroy(slots + i);
+        }
+        reset_ctrl();
+        num_elements = 0;
+    }
+
+    // 保证能放下 num_elements_hint 个元素而不扩容
+    void resize(size_type num_elements_hint) {
+        if (num_elements_hint > max_load(capacity))
+            rehash(capacity_for(num_elements_hint));
+    }
+
+    // 探测长度(按组计)直方图， 空槽和已删除槽的个数， 查找成功/失败平均探测的组数， 遍历所有槽
+    hashtable_stats stats() const;
+    // 扩容或原地重建后调用 cb， 传 nullptr 取消
+    void set_resize_callback(hashtable_resize_callback cb) { resize_callback = cb; }
+
+private:
+    static size_type max_load(size_type cap) { return cap - cap / 8; }
+    static size_type capacity_for(size_type n) {
+        size_type cap = flat_group_width;
+        while (max_load(cap) < n)
+            cap <<= 1;
+        return cap;
+    }
+
+    template <class K>
+    size_type hash_of(const K& key) const { return mystl::__flat_mix(hash(key)); }
+    static flat_ctrl_t h2_of(size_type h) { return static_cast<flat_ctrl_t>(h & 0x7f); }
+    __flat_probe probe(size_type h) const { return __flat_probe(h >> 7, capacity / flat_group_width - 1); }
+
+    iterator iterator_at(size_type i) { return iterator(ctrl + i, slots + i); }
+
+    void reset_ctrl() {
+        memset(ctrl, static_cast<unsigned char>(flat_ctrl_empty), capacity);
+        ctrl[capacity] = flat_ctrl_sentinel;
+        growth_left = max_load(capacity);
+    }
+
+    void initialize_slots(size_type cap) {
+        ctrl = ctrl_allocator::allocate(cap + 1);
+        try {
+            slots = slot_allocator::allocate(cap);
+        } catch (...) {
+            ctrl_allocator::deallocate(ctrl, cap + 1);
+            ctrl = nullptr;
+            throw;
+        }
+        capacity = cap;
+        reset_ctrl();
+    }
+
+    void destroy_slots() {
+        if (ctrl == nullptr)
+            return;
+        clear();
+        slot_allocator::deallocate(slots, capacity);
+        ctrl_allocator::deallocate(ctrl, capacity + 1);
+        ctrl = nullptr;
+        slots = nullptr;
+    }
+
+    template <class K>
+    iterator find_key(const K& key) {
+        return iterator_at(find_index(key, hash_of(key)));
+    }
+    template <class K>
+    const_iterator find_key(const K& key) const {
+        const size_type i = find_index(key, hash_of(key));
+        return const_iterator(ctrl + i, slots + i);
+    }
+    template <class K>
+    size_type count_key(const K& key) const;
+    template <class K>
+    size_type erase_key(const K& key) {
+        const size_type h = hash_of(key);
+        size_type res = 0;
+        for (size_type i = find_index(key, h); i != capacity; i = find_index(key, h)) {
+            erase_at(i);
+            ++res;
+        }
+        return res;
+    }
+
+    // 找 key 所在的槽， 找不到返回 capacity
+    template <class K>
+    size_type find_index(const K& key, size_type h) const {
+        const flat_ctrl_t h2 = h2_of(h);
+        for (__flat_probe p = probe(h); ; p.next()) {
+            const __flat_group g(ctrl + p.offset());
+            for (uint32_t m = g.match(h2); m != 0; m &= m - 1) {
+                const size_type i = p.offset() + mystl::__flat_lowest_bit(m);
+                if (equals(get_key(slots[i]), key))
+                    return i;
+            }
+            // 组里有空槽， 说明插入时探测序列没有越过这一组
+            if (g.match_empty() != 0)
+                return capacity;
+        }
+    }
+
+    // 探测序列上第一个空或已删除的槽
+    size_type find_first_non_full(size_type h) const {
+        for (__flat_probe p = probe(h); ; p.next()) {
+            const uint32_t m = __flat_group(ctrl + p.offset()).match_empty_or_deleted();
+            if (m != 0)
+                return p.offset() + mystl::__flat_lowest_bit(m);
+        }
+    }
+
+    // 用 args 构造新元素， 返回所在的槽
+    template <class... Args>
+    size_type insert_at(size_type h, Args&&... args) {
+        size_type i = find_first_non_full(h);
+        if (growth_left == 0 && ctrl[i] != flat_ctrl_deleted) {
+            // args 可能引用表内的元素， 扩容前先构造出新元素
+            value_type x_copy(mystl::forward<Args>(args)...);
+            rehash_and_grow();
+            i = find_first_non_full(h);
+            mystl::construct(slots + i, mystl::move(x_copy));
+        } else {
+            mystl::construct(slots + i, mystl::forward<Args>(args)...);
+        }
+        if (ctrl[i] == flat_ctrl_empty)
+            --growth_left;
+        ctrl[i] = h2_of(h);
+        ++num_elements;
+        return i;
+    }
+
+    // 同一组里还有空槽时直接置空， 否则可能有探测序列经过这里， 只能标记为已删除
+    void erase_at(size_type i) {
+        mystl::destroy(slots + i);
+        const size_type group_start = i & ~(flat_group_width - 1);
+        if (__flat_group(ctrl + group_start).match_empty() != 0) {
+            ctrl[i] = flat_ctrl_empty;
+            ++growth_left;
+        } else {
+            ctrl[i] = flat_ctrl_deleted;
+        }
+        --num_elements;
+    }
+
+    // 已删除的槽很多时原地重建， 否则容量翻倍
+    void rehash_and_grow() {
+        if (num_elements <= max_load(capacity) / 2)
+            rehash(capacity);
+        else
+            rehash(capacity * 2);
+    }
+
+    void rehash(size_type new_cap);
+    void copy_from(const flat_hashtable& ht);
+};
+
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+template <class K>
+typename flat_hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::size_type
+flat_hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::count_key(const K& key) const {
+    const size_type h = hash_of(key);
+    const flat_ctrl_t h2 = h2_of(h);
+    size_type res = 0;
+    for (__flat_probe p = probe(h); ; p.next()) {
+        const __flat_group g(ctrl + p.offset());
+        for (uint32_t m = g.match(h2); m != 0; m &= m - 1) {
+            if (equals(get_key(slots[p.offset() + mystl::__flat_lowest_bit(m)]), key))
+                ++res;
+        }
+        if (g.match_empty() != 0)
+            return res;
+    }
+}
+
+// 先把所有元素放进新数组(移动不会抛出异常时移动， 否则复制)， 全部成功后再析构旧元素
+// 中途抛出异常时旧表保持不变
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+void flat_hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::rehash(size_type new_cap) {
+    const __resize_timer timer(resize_callback, capacity);
+    // 容纳 max_load(new_cap) 个元素的最小槽数正好是 new_cap
+    flat_hashtable tmp(max_load(new_cap), hash, equals);
+    tmp.resize_callback = resize_callback;
+    for (size_type i = 0; i < capacity; ++i) {
+        if (ctrl[i] >= 0) {
+            const size_type h = hash_of(get_key(slots[i]));
+            const size_type j = tmp.find_first_non_full(h);
+            mystl::construct(tmp.slots + j, std::move_if_noexcept(slots[i]));
+            tmp.ctrl[j] = h2_of(h);
+            --tmp.growth_left;
+            ++tmp.num_elements;
+        }
+    }
+    swap(tmp);
+    timer.done(capacity);
+}
+
+// 元素的探测长度是它所在的组在探测序列里的序号(从 1 开始)
+// 查找失败时一直探测到有空槽的组， 每个起始组的概率相同
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+hashtable_stats flat_hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::stats() const {
+    hashtable_stats res;
+    res.buckets = capacity;
+    res.elements = num_elements;
+    size_type successful = 0;
+    for (size_type i = 0; i < capacity; ++i) {
+        if (ctrl[i] == flat_ctrl_empty) {
+            ++res.empty_buckets;
+        } else if (ctrl[i] == flat_ctrl_deleted) {
+            ++res.tombstones;
+        } else {
+            __flat_probe p = probe(hash_of(get_key(slots[i])));
+            while (p.group != i / flat_group_width)
+                p.next();
+            res.record(p.index + 1);
+            successful += p.index + 1;
+        }
+    }
+    const size_type groups = capacity / flat_group_width;
+    size_type unsuccessful = 0;
+    for (size_type g = 0; g < groups; ++g) {
+        __flat_probe p(g, groups - 1);
+        while (__flat_group(ctrl + p.offset()).match_empty() == 0)
+            p.next();
+        unsuccessful += p.index + 1;
+    }
+    res.finish(successful, static_cast<double>(unsuccessful) / groups);
+    return res;
+}
+
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+void flat_hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::copy_from(const flat_hashtable& ht) {
+    initialize_slots(ht.capacity);
+    try {
+        for (size_type i = 0; i < capacity; ++i) {
+            if (ht.ctrl[i] >= 0) {
+                mystl::construct(slots + i, ht.slots[i]);
+                ctrl[i] = ht.ctrl[i];
+                ++num_elements;
+            }
+        }
+    } catch (...) {
+        destroy_slots();
+        throw;
+    }
+    // 已删除的标记也要复制， 否则探测序列会在中途断开
+    memcpy(ctrl, ht.ctrl, capacity + 1);
+    growth_left = ht.growth_left;
+}
+
+}
+
+#endif //FJXTINYSTL_FLAT_HASHTABLE_H
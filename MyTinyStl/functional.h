@@ -48,6 +48,12 @@ struct equal_to : public binary_function<T, T, bool>
     bool operator()(const T& x, const T& y) const { return x == y; }
 };
 
+template <class T>
+struct less : public binary_function<T, T, bool>
+{
+    bool operator()(const T& x, const T& y) const { return x < y; }
+};
+
 // 选择函数， 接受一个pair, 返回第一个元素
 template <class Pair>
 struct selectfirst : public unary_function<Pair, typename Pair::first_type>
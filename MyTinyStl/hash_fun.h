@@ -5,6 +5,8 @@
 // Created by fengjiaxin on 2023/4/17.
 // 定义各种hash函数
 #include <cstddef> // size_t
+#include <type_traits>
+#include <string>
 
 // 对于大部分类型， hash function什么都不做
 namespace mystl
@@ -14,6 +16,11 @@ namespace mystl
 template<class Key>
 struct hash {};
 
+// hashtable 是否在节点里缓存 hash 值
+// 默认缓存， 计算 hash 代价很低的函数对象(整型原值)不缓存， 自定义 hash 可以特化为 false_type
+template <class HashFcn>
+struct __cache_hash_code : std::true_type {};
+
 
 // 对于整型类型，只是返回原值
 #define MYSTL_TRIVIAL_HASH_FCN(Type)         \
@@ -21,7 +28,8 @@ template <> struct hash<Type>                \
 {                                            \
   size_t operator()(Type val) const noexcept \
   { return static_cast<size_t>(val); }       \
-};
+};                                           \
+template <> struct __cache_hash_code<hash<Type>> : std::false_type {};
 
 MYSTL_TRIVIAL_HASH_FCN(bool)
 
@@ -64,6 +72,14 @@ inline size_t __stl_hash_string(const char *s) {
     return static_cast<size_t>(h);
 }
 
+// 指定长度的版本， 和上面的结果相同
+inline size_t __stl_hash_string(const char *s, size_t n) {
+    unsigned long h = 0;
+    for (size_t i = 0; i < n; ++i)
+        h = 5 * h + s[i];
+    return static_cast<size_t>(h);
+}
+
 template<>
 struct hash<char *> {
     size_t operator()(const char *s) const { return __stl_hash_string(s); }
@@ -74,6 +90,18 @@ struct hash<const char *> {
     size_t operator()(const char *s) const { return __stl_hash_string(s); }
 };
 
+template<>
+struct hash<std::string> {
+    size_t operator()(const std::string& s) const { return __stl_hash_string(s.data(), s.size()); }
+};
+
+// hash 函数和比较函数都带有 is_transparent 时， 查找可以直接使用和 key 可比较的其他类型
+// H， E 作为成员函数模板的默认参数传入， 使 SFINAE 推迟到调用时
+template <class H, class E, class R, class = typename H::is_transparent, class = typename E::is_transparent>
+struct __if_transparent {
+    typedef R type;
+};
+
 
 }
 
@@ -6,20 +6,26 @@
 //
 // Created by fengjiaxin on 2023/4/18.
 // hashmap
+// 底层 hash 表通过模板参数 HashTable 选择: hashtable(开链法， 默认)， flat_hashtable(开放寻址)，
+// robin_hood_hashtable(Robin Hood 开放寻址， 删除不留墓碑)
 #include "hashtable.h"
+#include "flat_hashtable.h"
+#include "robin_hood_hashtable.h"
 #include "functional.h"
 #include "hash_fun.h"
-#
+#include "util.h"
+#include <tuple>
 
 namespace mystl
 {
 
 
-template <class Key, class T, class HashFcn = mystl::hash<Key>, class EqualKey = mystl::equal_to<Key>>
+template <class Key, class T, class HashFcn = mystl::hash<Key>, class EqualKey = mystl::equal_to<Key>,
+          template <class...> class HashTable = mystl::hashtable>
 class hash_map {
 
 private:
-    typedef mystl::hashtable<std::pair<const Key, T>, Key, HashFcn, mystl::selectfirst<std::pair<const Key, T>>, EqualKey> ht;
+    typedef HashTable<std::pair<const Key, T>, Key, HashFcn, mystl::selectfirst<std::pair<const Key, T>>, EqualKey> ht;
     ht rep; // 底层机制 以 hash table完成
 public:
     typedef typename ht::key_type key_type;
@@ -52,7 +58,17 @@ public:
     size_type size() const { return rep.size(); }
     bool empty() const { return rep.empty(); }
     void swap(hash_map& hs) { rep.swap(hs.rep); }
-    friend bool operator==(const hash_map&, const hash_map&);
+    // 元素个数相同， 且每个元素都能在另一边找到相同的值
+    friend bool operator==(const hash_map& lhs, const hash_map& rhs) {
+        if (lhs.size() != rhs.size())
+            return false;
+        for (const_iterator it = lhs.begin(); it != lhs.end(); ++it) {
+            const_iterator pos = rhs.find(it->first);
+            if (pos == rhs.end() || !(pos->second == it->second))
+                return false;
+        }
+        return true;
+    }
 
     iterator begin() { return rep.begin(); }
     iterator end() { return rep.end(); }
@@ -65,38 +81,121 @@ public:
         return rep.insert_unique(obj);
     }
 
+    // 先查找 key， 已存在时不会移动 obj
+    std::pair<iterator, bool> insert(value_type&& obj) {
+        return rep.emplace_unique_key(obj.first, mystl::move(obj));
+    }
+
     std::pair<iterator, bool> insert_noresize(const value_type& obj) {
         return rep.insert_unique_noresize(obj);
     }
 
+    // 用 args 构造元素， 需要先构造出来才知道 key
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        return rep.emplace_unique(mystl::forward<Args>(args)...);
+    }
+
+    // key 不存在时才用 args 构造 mapped_type， 已存在时什么都不做
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+        return rep.emplace_unique_key(key, std::piecewise_construct, std::forward_as_tuple(key),
+                                      std::forward_as_tuple(mystl::forward<Args>(args)...));
+    }
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+        return rep.emplace_unique_key(key, std::piecewise_construct, std::forward_as_tuple(mystl::move(key)),
+                                      std::forward_as_tuple(mystl::forward<Args>(args)...));
+    }
+
+    // key 不存在时插入， 已存在时赋值
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+        std::pair<iterator, bool> res = try_emplace(key, mystl::forward<M>(obj));
+        if (!res.second)
+            res.first->second = mystl::forward<M>(obj);
+        return res;
+    }
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj) {
+        std::pair<iterator, bool> res = try_emplace(mystl::move(key), mystl::forward<M>(obj));
+        if (!res.second)
+            res.first->second = mystl::forward<M>(obj);
+        return res;
+    }
+
     iterator find(const key_type& key) { return rep.find(key);}
     const_iterator find(const key_type& key) const { return rep.find(key); }
 
+    // 命中时不构造任何临时对象
     T& operator[](const key_type& key) {
-        return rep.find_or_insert(value_type(key, T())).second;
+        return try_emplace(key).first->second;
+    }
+    T& operator[](key_type&& key) {
+        return try_emplace(mystl::move(key)).first->second;
     }
 
     size_type count(const key_type& key) const { return rep.count(key); }
     size_type erase(const key_type& key) { return rep.erase(key); }
     void erase(iterator it) { rep.erase(it); }
+
+    // key 不重复， 区间里最多一个元素
+    std::pair<iterator, iterator> equal_range(const key_type& key) { return single_range(find(key), end()); }
+    std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+        return single_range(find(key), end());
+    }
+
+    // 异构查找， 要求 HashFcn 和 EqualKey 都带有 is_transparent， 例如 hash<string_view> 和 equal_to<string_view>
+    template <class K, class H = HashFcn, class E = EqualKey>
+    typename __if_transparent<H, E, iterator>::type find(const K& key) { return rep.find(key); }
+    template <class K, class H = HashFcn, class E = EqualKey>
+    typename __if_transparent<H, E, const_iterator>::type find(const K& key) const { return rep.find(key); }
+    template <class K, class H = HashFcn, class E = EqualKey>
+    typename __if_transparent<H, E, size_type>::type count(const K& key) const { return rep.count(key); }
+    template <class K, class H = HashFcn, class E = EqualKey>
+    typename __if_transparent<H, E, size_type>::type erase(const K& key) { return rep.erase(key); }
+    template <class K, class H = HashFcn, class E = EqualKey>
+    typename __if_transparent<H, E, std::pair<iterator, iterator>>::type equal_range(const K& key) {
+        return single_range(find(key), end());
+    }
+    template <class K, class H = HashFcn, class E = EqualKey>
+    typename __if_transparent<H, E, std::pair<const_iterator, const_iterator>>::type equal_range(const K& key) const {
+        return single_range(find(key), end());
+    }
     void clear() {rep.clear(); }
 
 public:
     void resize(size_type hint) { rep.resize(hint); }
+    // 渐进式 rehash， 只有开链法的 hashtable 支持
+    void incremental_rehash(size_type buckets_per_insert) { rep.incremental_rehash(buckets_per_insert); }
+    bool is_rehashing() const { return rep.is_rehashing(); }
+    void complete_rehash() { rep.complete_rehash(); }
+    // 负载因子， reserve/rehash 和 erase 后的收缩， 只有开链法的 hashtable 支持
+    float load_factor() const { return rep.load_factor(); }
+    float max_load_factor() const { return rep.max_load_factor(); }
+    void max_load_factor(float ml) { rep.max_load_factor(ml); }
+    float min_load_factor() const { return rep.min_load_factor(); }
+    void min_load_factor(float ml) { rep.min_load_factor(ml); }
+    void reserve(size_type n) { rep.reserve(n); }
+    void rehash(size_type n) { rep.rehash(n); }
     size_type bucket_count() const { return rep.bucket_count(); }
     size_type max_bucket_count() const { return rep.max_bucket_count(); }
     size_type elems_in_bucket(size_type n) const { return rep.elems_in_bucket(n); }
+    // 健康统计和扩容回调， 三种底层 hash 表都支持， 含义见 hashtable_stats.h
+    hashtable_stats stats() const { return rep.stats(); }
+    void set_resize_callback(hashtable_resize_callback cb) { rep.set_resize_callback(cb); }
 
+private:
+    template <class Iter>
+    static std::pair<Iter, Iter> single_range(Iter it, Iter last) {
+        Iter next = it;
+        if (next != last)
+            ++next;
+        return std::pair<Iter, Iter>(it, next);
+    }
 };
 
 
 
-template<class Key, class T, class HashFcn, class EqualKey>
-inline bool operator==(const hash_map<Key, T, HashFcn, EqualKey> left,const hash_map<Key, T, HashFcn, EqualKey> right) {
-    return left.rep == right.rep;
-}
-
-
-
 }
 #endif //FJXTINYSTL_HASH_MAP_H
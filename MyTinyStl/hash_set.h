@@ -4,17 +4,22 @@
 //
 // Created by fengjiaxin on 2023/4/17.
 // hash set
+// 底层 hash 表通过模板参数 HashTable 选择: hashtable(开链法， 默认)， flat_hashtable(开放寻址)，
+// robin_hood_hashtable(Robin Hood 开放寻址， 删除不留墓碑)
 #include "hashtable.h"
+#include "flat_hashtable.h"
+#include "robin_hood_hashtable.h"
 #include "functional.h"
 #include "hash_fun.h"
 
 namespace mystl {
 
-template <class Value, class HashFcn = mystl::hash<Value>, class EqualKey = mystl::equal_to<Value>>
+template <class Value, class HashFcn = mystl::hash<Value>, class EqualKey = mystl::equal_to<Value>,
+          template <class...> class HashTable = mystl::hashtable>
 class hash_set
 {
 private:
-    typedef mystl::hashtable<Value, Value, HashFcn, mystl::identity<Value>, EqualKey> ht;
+    typedef HashTable<Value, Value, HashFcn, mystl::identity<Value>, EqualKey> ht;
     ht rep; // 底层机制 以 hash table完成
 
 public: // 型别定义
@@ -44,10 +49,19 @@ public: // 构造函数
             : rep(n, hf, eql) {}
 
 public: // 基础属性api
-    size_type size() { return rep.size(); }
-    bool empty() { return rep.empty(); }
+    size_type size() const { return rep.size(); }
+    bool empty() const { return rep.empty(); }
     void swap(hash_set& hs) { rep.swap(hs.rep);}
-    friend bool operator==(const hash_set& , const hash_set&);
+    // 元素个数相同， 且每个元素都能在另一边找到
+    friend bool operator==(const hash_set& lhs, const hash_set& rhs) {
+        if (lhs.size() != rhs.size())
+            return false;
+        for (typename ht::const_iterator it = lhs.rep.begin(); it != lhs.rep.end(); ++it) {
+            if (rhs.rep.find(*it) == rhs.rep.end())
+                return false;
+        }
+        return true;
+    }
 
     iterator begin() { return rep.begin(); }
     iterator end() { return rep.end(); }
@@ -58,29 +72,72 @@ public: // 涉及到改变数据的操作api
         return std::pair<iterator,bool>(p.first, p.second);
     }
 
+    // 先查找， 已存在时不会移动 obj
+    std::pair<iterator, bool> insert(value_type&& obj) {
+        return rep.emplace_unique_key(obj, mystl::move(obj));
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        return rep.emplace_unique(mystl::forward<Args>(args)...);
+    }
+
     std::pair<iterator, bool> insert_noresize(const value_type& obj) {
         std::pair<typename ht::iterator, bool> p = rep.insert_unique_noresize(obj);
         return std::pair<iterator, bool>(p.first, p.second);
     }
 
-    iterator find(const key_type& key) const { return rep.find(key);}
+    iterator find(const key_type& key) { return rep.find(key);}
     size_type count(const key_type& key) const { return rep.count(key); }
 
     size_type erase(const key_type& key) { return rep.erase(key);}
     void erase(iterator it) { rep.erase(it); }
+
+    // key 不重复， 区间里最多一个元素
+    std::pair<iterator, iterator> equal_range(const key_type& key) { return single_range(find(key)); }
+
+    // 异构查找， 要求 HashFcn 和 EqualKey 都带有 is_transparent， 例如 hash<string_view> 和 equal_to<string_view>
+    template <class K, class H = HashFcn, class E = EqualKey>
+    typename __if_transparent<H, E, iterator>::type find(const K& key) { return rep.find(key); }
+    template <class K, class H = HashFcn, class E = EqualKey>
+    typename __if_transparent<H, E, size_type>::type count(const K& key) const { return rep.count(key); }
+    template <class K, class H = HashFcn, class E = EqualKey>
+    typename __if_transparent<H, E, size_type>::type erase(const K& key) { return rep.erase(key); }
+    template <class K, class H = HashFcn, class E = EqualKey>
+    typename __if_transparent<H, E, std::pair<iterator, iterator>>::type equal_range(const K& key) {
+        return single_range(find(key));
+    }
     void clear() { rep.clear(); }
 
 public: // 一些辅助函数
     void resize(size_type hint) { rep.resize(hint); }
+    // 渐进式 rehash， 只有开链法的 hashtable 支持
+    void incremental_rehash(size_type buckets_per_insert) { rep.incremental_rehash(buckets_per_insert); }
+    bool is_rehashing() const { return rep.is_rehashing(); }
+    void complete_rehash() { rep.complete_rehash(); }
+    // 负载因子， reserve/rehash 和 erase 后的收缩， 只有开链法的 hashtable 支持
+    float load_factor() const { return rep.load_factor(); }
+    float max_load_factor() const { return rep.max_load_factor(); }
+    void max_load_factor(float ml) { rep.max_load_factor(ml); }
+    float min_load_factor() const { return rep.min_load_factor(); }
+    void min_load_factor(float ml) { rep.min_load_factor(ml); }
+    void reserve(size_type n) { rep.reserve(n); }
+    void rehash(size_type n) { rep.rehash(n); }
     size_type bucket_count() const { return rep.bucket_count(); }
     size_type max_bucket_count() const { return rep.max_bucket_count(); }
     size_type elems_in_bucket(size_type n) const { return rep.elems_in_bucket(n); }
-};
+    // 健康统计和扩容回调， 三种底层 hash 表都支持， 含义见 hashtable_stats.h
+    hashtable_stats stats() const { return rep.stats(); }
+    void set_resize_callback(hashtable_resize_callback cb) { rep.set_resize_callback(cb); }
 
-template <class Value, class HashFcn, class EqualKey>
-inline bool operator==(const hash_set<Value, HashFcn, EqualKey> left, const hash_set<Value, HashFcn, EqualKey> right) {
-    return left.rep == right.rep;
-}
+private:
+    std::pair<iterator, iterator> single_range(iterator it) {
+        iterator next = it;
+        if (next != end())
+            ++next;
+        return std::pair<iterator, iterator>(it, next);
+    }
+};
 
 }
 
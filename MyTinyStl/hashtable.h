@@ -4,20 +4,49 @@
 //
 // Created by fengjiaxin on 2023/4/15.
 // hash表， 使用开链法处理冲突
+// begin() 从记录的第一个非空桶开始， O(1)； operator++ 走完一条链后逐个检查后面的桶，
+// 完整遍历一次仍是 O(size + 桶数)， 稀疏的表或刚 clear 过的表遍历时要扫过所有空桶
 //
 #include "vector.h"
 #include "util.h"
 #include "iterator.h"
 #include <utility>
+#include <stdint.h>
+#include <stdlib.h> // calloc, free
+#include <new>      // bad_alloc
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h> // mmap, munmap
+#define HASHTABLE_HAS_MMAP 1
+#endif
+#include <cmath>
 #include "algo.h"
+#include "hash_fun.h"
+#include "hashtable_stats.h"
+
+// 渐进式 rehash 时每次插入或 erase(key) 最多搬迁的旧桶个数， 0 表示扩容时一次搬完
+// 也可以对单个 hashtable 调用 incremental_rehash 设置
+// 新桶数组不逐个写空指针， 大数组由操作系统按页延迟清零， 触发扩容的那次插入只付出分配的开销
+#ifndef HASHTABLE_REHASH_STEP
+#define HASHTABLE_REHASH_STEP 0
+#endif
 
 namespace mystl
 {
 
 
+// 节点里缓存的 hash 值， 不缓存时为空基类
+template <bool CacheHash>
+struct hashtable_hash_code {
+    size_t hash_code;
+};
+
+template <>
+struct hashtable_hash_code<false> {};
+
 // hashtable 的节点定义
-template <class Value>
-struct hashtable_node
+// CacheHash 为 true 时节点保存完整的 hash 值， rehash 和迭代器跨桶时不必重新计算 hash
+template <class Value, bool CacheHash = false>
+struct hashtable_node : public hashtable_hash_code<CacheHash>
 {
     hashtable_node* next;
     Value value;
@@ -25,29 +54,192 @@ struct hashtable_node
     hashtable_node() = default;
     hashtable_node(const Value& n):next(nullptr), value(n) {}
 
-    hashtable_node(const hashtable_node& node):next(node.next),value(node.value) {}
-    hashtable_node(hashtable_node&& node):next(node.next),value(node.value) {
+    hashtable_node(const hashtable_node& node)
+        :hashtable_hash_code<CacheHash>(node), next(node.next),value(node.value) {}
+    hashtable_node(hashtable_node&& node)
+        :hashtable_hash_code<CacheHash>(node), next(node.next),value(node.value) {
         node.next = nullptr;
     }
 };
 
+// 不小于这个字节数的桶数组直接向操作系统映射匿名内存
+#ifndef HASHTABLE_MMAP_BYTES
+#define HASHTABLE_MMAP_BYTES (64 * 1024)
+#endif
+
+// 桶数组， 分配时就是全 0， 不逐个写入空指针
+// 大数组用 mmap 映射零页， 第一次写入某一页时才真正分配， 清零的开销分摊到之后的访问里
+// 不直接用 calloc: glibc 释放过大块内存后会调高 mmap 阈值， calloc 改从堆上复用内存， 这时要整块 memset
+// 小数组和没有 mmap 的平台用 calloc
+// 假定空指针的二进制表示全为 0， 主流平台都满足
+template <class T>
+class __bucket_array {
+private:
+    T* data_;
+    size_t size_;
+
+    static bool use_mmap(size_t n) {
+#ifdef HASHTABLE_HAS_MMAP
+        return n * sizeof(T) >= HASHTABLE_MMAP_BYTES;
+#else
+        (void)n;
+        return false;
+#endif
+    }
+    static T* allocate(size_t n) {
+#ifdef HASHTABLE_HAS_MMAP
+        if (use_mmap(n)) {
+            void* p = mmap(nullptr, n * sizeof(T), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            return p == MAP_FAILED ? nullptr : static_cast<T*>(p);
+        }
+#endif
+        return static_cast<T*>(calloc(n, sizeof(T)));
+    }
+    static void deallocate(T* p, size_t n) {
+#ifdef HASHTABLE_HAS_MMAP
+        if (use_mmap(n)) {
+            munmap(p, n * sizeof(T));
+            return;
+        }
+#endif
+        (void)n;
+        free(p);
+    }
+
+public:
+    __bucket_array() : data_(nullptr), size_(0) {}
+    explicit __bucket_array(size_t n) : data_(nullptr), size_(0) {
+        if (n != 0) {
+            data_ = allocate(n);
+            if (data_ == nullptr)
+                throw std::bad_alloc();
+            size_ = n;
+        }
+    }
+    __bucket_array(const __bucket_array&) = delete;
+    __bucket_array& operator=(const __bucket_array&) = delete;
+    ~__bucket_array() {
+        if (data_ != nullptr)
+            deallocate(data_, size_);
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    T& operator[](size_t n) { return data_[n]; }
+    const T& operator[](size_t n) const { return data_[n]; }
+    void swap(__bucket_array& rhs) {
+        mystl::swap(data_, rhs.data_);
+        mystl::swap(size_, rhs.size_);
+    }
+};
+
+// bucket 的长度
+// Note: assumes long is at least 32 bits.
+static const int stl_num_primes = 28;
+static const unsigned long stl_prime_list[stl_num_primes] =
+{
+        53,         97,           193,         389,       769,
+        1543,       3079,         6151,        12289,     24593,
+        49157,      98317,        196613,      393241,    786433,
+        1572869,    3145739,      6291469,     12582917,  25165843,
+        50331653,   100663319,    201326611,   402653189, 805306457,
+        1610612741, 3221225473ul, 4294967291ul
+};
+
+inline unsigned long stl_next_prime(unsigned long n)
+{
+    const unsigned long* first = stl_prime_list;
+    const unsigned long* last = stl_prime_list + stl_num_primes;
+    const unsigned long* pos = lower_bound(first, last, n);
+    return pos == last ? *(last - 1) : *pos;
+}
+
+
+// bucket 策略， 决定 bucket 的个数以及 hash 值到 bucket 的映射
+// 1. prime_bucket_policy: bucket 数为质数， 取模用预先算好的倒数(fastmod)代替除法
+// 2. pow2_bucket_policy: bucket 数为 2 的幂次， 用 Fibonacci 乘法取高位， 整数 hash 原值也能打散
+// 策略对象保存在 hashtable 里， bucket 数改变时调用 reset
+struct prime_bucket_policy {
+    size_t n;
+#if defined(__SIZEOF_INT128__)
+    uint64_t m; // ceil(2^64 / n)
+#endif
+
+    prime_bucket_policy() : n(1) {
+#if defined(__SIZEOF_INT128__)
+        m = 0;
+#endif
+    }
+
+    size_t next_size(size_t hint) const { return mystl::stl_next_prime(hint); }
+    size_t max_bucket_count() const { return stl_prime_list[stl_num_primes - 1]; }
+
+    void reset(size_t bucket_count) {
+        n = bucket_count;
+#if defined(__SIZEOF_INT128__)
+        m = UINT64_MAX / n + 1;
+#endif
+    }
+
+    // 质数都小于 2^32， hash 值先折叠成 32 位， 再用两次乘法求余数
+    size_t index(size_t h) const {
+        const uint32_t a = static_cast<uint32_t>(static_cast<uint64_t>(h) ^ (static_cast<uint64_t>(h) >> 32));
+#if defined(__SIZEOF_INT128__)
+        const uint64_t lowbits = m * a;
+        return static_cast<size_t>((static_cast<unsigned __int128>(lowbits) * n) >> 64);
+#else
+        return a % n;
+#endif
+    }
+};
+
+struct pow2_bucket_policy {
+    size_t shift; // 64 - log2(bucket 数)
+
+    pow2_bucket_policy() : shift(63) {}
+
+    size_t next_size(size_t hint) const {
+        size_t res = 8;
+        while (res < hint)
+            res <<= 1;
+        return res;
+    }
+    size_t max_bucket_count() const { return static_cast<size_t>(1) << (sizeof(size_t) * 8 - 2); }
+
+    void reset(size_t bucket_count) {
+        shift = 64;
+        while (bucket_count > 1) {
+            bucket_count >>= 1;
+            --shift;
+        }
+    }
+
+    // 先把高位折叠到低位， 再乘 2^64 / 黄金分割比， 取最高的 log2(n) 位
+    size_t index(size_t h) const {
+        uint64_t x = static_cast<uint64_t>(h);
+        x ^= x >> shift;
+        return static_cast<size_t>((x * 11400714819323198485ULL) >> shift);
+    }
+};
+
 // 前置声明
-template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey,
+          class BucketPolicy = prime_bucket_policy>
 class hashtable;
 
-template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
 struct hashtable_iterator;
 
-template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
 struct hashtable_const_iterator;
 
 // 迭代器
-template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
 struct hashtable_iterator {
-    typedef hashtable<Value, Key, HashFcn, ExtractKey, EqualKey> hashtable;
-    typedef hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey> iterator;
-    typedef hashtable_const_iterator<Value, Key, HashFcn, ExtractKey, EqualKey> const_iterator;
-    typedef hashtable_node<Value> node;
+    typedef hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy> table;
+    typedef hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy> iterator;
+    typedef hashtable_const_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy> const_iterator;
+    typedef hashtable_node<Value, __cache_hash_code<HashFcn>::value> node;
 
     // 迭代器5种基本类型
     typedef mystl::forward_iterator_tag iterator_category;
@@ -58,12 +250,13 @@ struct hashtable_iterator {
     typedef Value *pointer;
 
     node* cur;
-    hashtable* ht;
+    table* ht;
+    size_type bucket; // cur 所在的桶， ++ 走到链表末尾时从下一个桶继续找， 不必重新计算 hash
 
     // 构造函数
     hashtable_iterator() {}
 
-    hashtable_iterator(node* n, hashtable* h) : cur(n), ht(h) {}
+    hashtable_iterator(node* n, table* h, size_type b) : cur(n), ht(h), bucket(b) {}
 
     // 操作符重载
     reference operator*() const { return cur->value; }
@@ -80,12 +273,12 @@ struct hashtable_iterator {
 };
 
 // 迭代器
-template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
 struct hashtable_const_iterator {
-    typedef hashtable<Value, Key, HashFcn, ExtractKey, EqualKey> hashtable;
-    typedef hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey> iterator;
-    typedef hashtable_const_iterator<Value, Key, HashFcn, ExtractKey, EqualKey> const_iterator;
-    typedef hashtable_node<Value> node;
+    typedef hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy> table;
+    typedef hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy> iterator;
+    typedef hashtable_const_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy> const_iterator;
+    typedef hashtable_node<Value, __cache_hash_code<HashFcn>::value> node;
 
     // 迭代器5种基本类型
     typedef mystl::forward_iterator_tag iterator_category;
@@ -95,20 +288,21 @@ struct hashtable_const_iterator {
     typedef const Value& reference;
     typedef const Value* pointer;
 
-    node* cur;
-    hashtable* ht;
+    const node* cur;
+    const table* ht;
+    size_type bucket;
 
     // 构造函数
     hashtable_const_iterator() {}
 
-    hashtable_const_iterator(const node* n, const hashtable* h) : cur(n), ht(h) {}
+    hashtable_const_iterator(const node* n, const table* h, size_type b) : cur(n), ht(h), bucket(b) {}
 
-    hashtable_const_iterator(const iterator& it) : cur(it.cur), ht(it.ht) {}
+    hashtable_const_iterator(const iterator& it) : cur(it.cur), ht(it.ht), bucket(it.bucket) {}
 
     // 操作符重载
     reference operator*() const { return cur->value; }
 
-    reference operator->() const { return &(operator*()); }
+    pointer operator->() const { return &(operator*()); }
 
     bool operator==(const const_iterator &it) const { return cur == it.cur; }
 
@@ -121,28 +315,7 @@ struct hashtable_const_iterator {
 
 
 
-// bucket 的长度
-// Note: assumes long is at least 32 bits.
-static const int stl_num_primes = 28;
-static const unsigned long stl_prime_list[stl_num_primes] =
-{
-        53,         97,           193,         389,       769,
-        1543,       3079,         6151,        12289,     24593,
-        49157,      98317,        196613,      393241,    786433,
-        1572869,    3145739,      6291469,     12582917,  25165843,
-        50331653,   100663319,    201326611,   402653189, 805306457,
-        1610612741, 3221225473ul, 4294967291ul
-};
-
-inline unsigned long stl_next_prime(unsigned long n)
-{
-    const unsigned long* first = stl_prime_list;
-    const unsigned long* last = stl_prime_list + stl_num_primes;
-    const unsigned long* pos = lower_bound(first, last, n);
-    return pos == last ? *(last - 1) : *pos;
-}
-
-template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
 class hashtable {
 public:
     typedef Key  key_type;
@@ -161,21 +334,43 @@ public:
     hasher hash_func() const { return hash; }
     key_equal key_eq() const { return equals; }
 
-    typedef hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey> iterator;
-    typedef hashtable_const_iterator<Value, Key, HashFcn, ExtractKey, EqualKey> const_iterator;
-    friend struct hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey>;
-    friend struct hashtable_const_iterator<Value, Key, HashFcn, ExtractKey, EqualKey>;
+    typedef hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy> iterator;
+    typedef hashtable_const_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy> const_iterator;
+    friend struct hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>;
+    friend struct hashtable_const_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>;
 
 private:
-    typedef hashtable_node<Value> node;
+    typedef hashtable_node<Value, __cache_hash_code<HashFcn>::value> node;
     typedef mystl::allocator<node>    node_allocator;
 
 
     hasher  hash;
     key_equal equals;
     ExtractKey get_key;
-    mystl::vector<node*> buckets;
+    typedef __bucket_array<node*> bucket_array;
+    bucket_array buckets;
     size_type num_elements;
+    BucketPolicy policy;
+    // 第一个非空桶， 只由修改表的操作维护: 插入时变小， clear/rebuild 重置，
+    // 任何 erase 删空这个桶时后移； begin() 从这里往后找， 不修改它， const 的表可以多线程同时读
+    size_type first_bucket;
+
+    // 渐进式 rehash: 扩容后旧桶数组先保留， 之后每次插入搬迁 rehash_batch 个旧桶
+    // 搬迁期间元素分布在两个数组里， 查找和删除两边都要看
+    // 迭代器的桶下标把两个数组连起来编号: [0, buckets.size()) 是新桶， 之后是旧桶
+    bucket_array old_buckets;
+    BucketPolicy old_policy;
+    size_type rehash_idx;   // 下一个要搬迁的旧桶
+    size_type rehash_batch; // 0 表示扩容时一次搬完
+
+    // 负载因子 = 元素个数 / 桶数
+    // 超过 max_load 时扩容; 开启收缩时， erase 后低于 min_load 就收缩到负载约为 max_load / 2
+    // min_load 不超过 max_load / 4， 收缩后要再插入一倍的元素才会扩容， 不会来回抖动
+    float max_load;
+    float min_load;          // 0 表示不收缩
+    size_type reserved;      // reserve 过的元素个数， 收缩时桶数不低于它所需的桶数
+
+    hashtable_resize_callback resize_callback; // 换桶数组后调用， 默认为空
 
 public:
     // 和容量相关的查询
@@ -187,32 +382,36 @@ public:
         mystl::swap(get_key, ht.get_key);
         buckets.swap(ht.buckets);
         mystl::swap(num_elements, ht.num_elements);
+        mystl::swap(policy, ht.policy);
+        mystl::swap(first_bucket, ht.first_bucket);
+        old_buckets.swap(ht.old_buckets);
+        mystl::swap(old_policy, ht.old_policy);
+        mystl::swap(rehash_idx, ht.rehash_idx);
+        mystl::swap(rehash_batch, ht.rehash_batch);
+        mystl::swap(max_load, ht.max_load);
+        mystl::swap(min_load, ht.min_load);
+        mystl::swap(reserved, ht.reserved);
+        mystl::swap(resize_callback, ht.resize_callback);
     }
-    // 查询边界
+    // 查询边界， first_bucket 恰好是第一个非空桶， begin() O(1)
     iterator begin() {
-        for (size_type i = 0; i < buckets.size(); ++i) {
-            if (buckets[i] != nullptr)
-                return iterator(buckets[i], this);
-        }
-        return end();
+        const size_type n = skip_empty_buckets();
+        return n == slot_count() ? end() : iterator(slot(n), this, n);
     }
 
     const_iterator begin() const {
-        for (size_type i = 0; i < buckets.size(); ++i) {
-            if (buckets[i] != nullptr)
-                return const_iterator(buckets[i], this);
-        }
-        return end();
+        const size_type n = skip_empty_buckets();
+        return n == slot_count() ? end() : const_iterator(slot(n), this, n);
     }
 
-    iterator end() { return iterator(nullptr, this); }
+    iterator end() { return iterator(nullptr, this, slot_count()); }
 
-    const_iterator end() const { return const_iterator(nullptr, this); }
+    const_iterator end() const { return const_iterator(nullptr, this, slot_count()); }
 
 public:
     // 和bucket 相关的helper function
     size_type bucket_count() const { return buckets.size(); }
-    size_type max_bucket_count() const { return stl_prime_list[stl_num_primes - 1];}
+    size_type max_bucket_count() const { return policy.max_bucket_count(); }
     size_type elems_in_bucket(size_type bucket) const {
         size_type res = 0;
         for (node* cur = buckets[bucket]; cur != nullptr;cur = cur->next)
@@ -227,58 +426,152 @@ public:
     }
 
     // 插入元素， 允许重复
-    std::pair<iterator, bool> insert_equal(const value_type& obj) {
+    iterator insert_equal(const value_type& obj) {
         resize(num_elements + 1);
         return insert_equal_noresize(obj);
     }
 
-    size_type erase(const key_type& key);
-    void erase(const iterator& it);
+    // 先按 key 查找， 找不到时才用 args 在节点里构造元素， key 不能引用 args 构造出的元素
+    template <class... Args>
+    std::pair<iterator, bool> emplace_unique_key(const key_type& key, Args&&... args);
 
-    void clear(); // 并未释放掉vector空间，仍保持原来大小
+    // 先构造节点才能得到 key， key 已存在时销毁新节点
+    template <class... Args>
+    std::pair<iterator, bool> emplace_unique(Args&&... args);
 
-    reference find_or_insert(const value_type& obj);
-    iterator find(const key_type& key) {
-        size_type n = bkt_num_key(key);
-        node* first = buckets[n];
-        while (first && !equals(get_key(first->value), key)) {
-            first = first->next;
-        }
-        return iterator(first, this);
+    // 是否需要重建表格
+    void resize(size_type num_elements_hint);
+
+    // 负载因子相关
+    float load_factor() const { return static_cast<float>(num_elements) / buckets.size(); }
+    float max_load_factor() const { return max_load; }
+    void max_load_factor(float ml) {
+        max_load = ml;
+        min_load_factor(min_load);
+        resize(num_elements);
+    }
+    float min_load_factor() const { return min_load; }
+    // 开启 erase 后的自动收缩， 0 表示关闭; 开启后 erase(key) 可能 rehash， 使迭代器失效
+    void min_load_factor(float ml) {
+        min_load = ml < max_load / 4 ? ml : max_load / 4;
     }
 
-    const_iterator find(const key_type& key) const {
-        size_type n = bkt_num_key(key);
-        node* first = buckets[n];
-        while (first && !equals(get_key(first->value), key)) {
-            first = first->next;
+    // 保证放下 n 个元素不会扩容， 之后收缩也不会低于这个容量
+    void reserve(size_type n) {
+        reserved = n;
+        resize(n);
+    }
+    // 桶数改为至少 n 个， 同时满足当前元素个数的负载要求， 可以变小
+    void rehash(size_type n) {
+        const size_type need = buckets_for(num_elements);
+        const size_type new_n = next_size(n > need ? n : need);
+        if (new_n != buckets.size()) {
+            complete_rehash();
+            rebuild(new_n);
         }
-        return const_iterator(first, this);
     }
 
-    size_type count(const key_type& key) const {
-        const size_type n = bkt_num_key(key);
-        size_type res = 0;
-        const node* cur = buckets[n];
-        while (cur) {
-            if (equals(get_key(cur->value), key))
-                ++res;
-            cur = cur->next;
-        }
+    // 设置渐进式 rehash 每次插入或 erase(key) 搬迁的旧桶个数， 0 表示关闭(正在搬迁的会立即搬完)
+    // 开启后插入和 erase(key) 可能搬迁节点， 使迭代器失效， 但元素的指针和引用仍然有效
+    // find/count 不推进搬迁， 之后只读的表可以调用 complete_rehash 搬完并释放旧桶
+    void incremental_rehash(size_type buckets_per_insert) {
+        rehash_batch = buckets_per_insert;
+        if (rehash_batch == 0)
+            complete_rehash();
+    }
+    bool is_rehashing() const { return !old_buckets.empty(); }
+    // 立即搬完正在进行的渐进式 rehash， 释放旧桶数组
+    void complete_rehash() {
+        while (rehash_idx < old_buckets.size())
+            migrate_bucket(rehash_idx++);
+        finish_rehash();
+    }
+
+    // 链长直方图， 最长链， 空桶比例， 查找成功/失败平均比较的节点数， 遍历所有桶
+    hashtable_stats stats() const;
+    // 扩容， 收缩和 rehash 换桶数组后调用 cb， 传 nullptr 取消
+    void set_resize_callback(hashtable_resize_callback cb) { resize_callback = cb; }
+    // 在不需要重建表格的情况下插入新节点，键值不允许重复
+    std::pair<iterator, bool> insert_unique_noresize(const value_type& obj);
+    // 在不需要重建表格的情况下插入新节点，键值允许重复
+    iterator insert_equal_noresize(const value_type& obj);
+
+    size_type erase(const key_type& key) {
+        if (is_rehashing())
+            rehash_step();
+        const size_type res = erase_key(key);
+        shrink_if_sparse();
+        return res;
+    }
+    void erase(const iterator& it);
+
+    void clear(); // 并未释放掉vector空间，仍保持原来大小
+
+    reference find_or_insert(const value_type& obj);
+    iterator find(const key_type& key) { return find_key(key); }
+    const_iterator find(const key_type& key) const { return find_key(key); }
+    size_type count(const key_type& key) const { return count_key(key); }
+
+    // 异构查找: HashFcn 和 EqualKey 都带有 is_transparent 时， key 可以是任何能和 key_type 一起 hash/比较的类型
+    template <class K, class H = HashFcn, class E = EqualKey>
+    typename __if_transparent<H, E, iterator>::type find(const K& key) { return find_key(key); }
+    template <class K, class H = HashFcn, class E = EqualKey>
+    typename __if_transparent<H, E, const_iterator>::type find(const K& key) const { return find_key(key); }
+    template <class K, class H = HashFcn, class E = EqualKey>
+    typename __if_transparent<H, E, size_type>::type count(const K& key) const { return count_key(key); }
+    template <class K, class H = HashFcn, class E = EqualKey>
+    typename __if_transparent<H, E, size_type>::type erase(const K& key) {
+        if (is_rehashing())
+            rehash_step();
+        const size_type res = erase_key(key);
+        shrink_if_sparse();
         return res;
     }
 
 
 
 private:
-    size_type next_size(size_type n) const { return mystl::stl_next_prime(n);}
+    size_type next_size(size_type n) const { return policy.next_size(n); }
+
+    template <class K>
+    iterator find_key(const K& key) {
+        size_type n;
+        node* p = find_node(key, hash(key), n);
+        return p ? iterator(p, this, n) : end();
+    }
+    template <class K>
+    const_iterator find_key(const K& key) const {
+        size_type n;
+        const node* p = find_node(key, hash(key), n);
+        return p ? const_iterator(p, this, n) : end();
+    }
+    template <class K>
+    size_type count_key(const K& key) const {
+        const size_type code = hash(key);
+        size_type res = count_in_chain(buckets[policy.index(code)], code, key);
+        if (is_rehashing())
+            res += count_in_chain(old_buckets[old_policy.index(code)], code, key);
+        return res;
+    }
+    template <class K>
+    size_type erase_key(const K& key) {
+        const size_type code = hash(key);
+        size_type res = erase_in_chain(buckets[policy.index(code)], code, key);
+        if (is_rehashing())
+            res += erase_in_chain(old_buckets[old_policy.index(code)], code, key);
+        if (res != 0)
+            advance_first_bucket();
+        return res;
+    }
 
-    // 创建/销毁 节点
-    node* new_node(const value_type& value) {
+    // 创建/销毁 节点， code 是新元素的 hash 值
+    template <class... Args>
+    node* new_node(size_type code, Args&&... args) {
         node* ptr = node_allocator::allocate();
         ptr->next = nullptr;
         try {
-            mystl::construct(&ptr->value, value);
+            mystl::construct(&ptr->value, mystl::forward<Args>(args)...);
+            set_hash_code(ptr, code, cache_hash());
             return ptr;
         } catch (...) {
             node_allocator::deallocate(ptr);
@@ -290,158 +583,445 @@ private:
         node_allocator::deallocate(ptr);
     }
 
+    // 放下 n 个元素需要的桶数
+    size_type buckets_for(size_type n) const {
+        return static_cast<size_type>(std::ceil(static_cast<double>(n) / max_load));
+    }
+    // 重建为 n 个桶， 不能处于渐进式 rehash 中
+    void rebuild(size_type n);
+    // erase 之后负载低于 min_load 时收缩， erase(iterator) 不调用， 边遍历边删除时迭代器保持有效
+    void shrink_if_sparse() {
+        if (min_load > 0 && num_elements < buckets.size() * min_load) {
+            const size_type need = buckets_for(2 * num_elements);
+            const size_type floor = buckets_for(reserved);
+            const size_type new_n = next_size(need > floor ? need : floor);
+            if (new_n < buckets.size()) {
+                complete_rehash();
+                rebuild(new_n);
+            }
+        }
+    }
+
     void initialize_buckets(size_type n) {
-        const size_type n_buckets = next_size(n);
-        buckets.reserve(n_buckets);
-        buckets.insert(buckets.end(), n_buckets, nullptr);
+        const size_type n_buckets = next_size(buckets_for(n));
+        bucket_array(n_buckets).swap(buckets);
         num_elements = 0;
+        policy.reset(n_buckets);
+        first_bucket = n_buckets;
     }
 
     // 和 hash相关的helper function
-    // 计算应该在哪个桶
-    size_type bkt_num_key(const key_type& key, size_t n) const {
-        return hash(key) % n;
+    typedef std::integral_constant<bool, __cache_hash_code<HashFcn>::value> cache_hash;
+
+    static void set_hash_code(node* p, size_type code, std::true_type) { p->hash_code = code; }
+    static void set_hash_code(node*, size_type, std::false_type) {}
+
+    // 节点的 hash 值， 缓存时直接读取
+    size_type node_hash(const node* p, std::true_type) const { return p->hash_code; }
+    size_type node_hash(const node* p, std::false_type) const { return hash(get_key(p->value)); }
+    size_type node_hash(const node* p) const { return node_hash(p, cache_hash()); }
+
+    // 先比较缓存的 hash 值， 不相等就不必调用 equals
+    static bool hash_code_equals(const node* p, size_type code, std::true_type) { return p->hash_code == code; }
+    static bool hash_code_equals(const node*, size_type, std::false_type) { return true; }
+    template <class K>
+    bool node_equals(const node* p, size_type code, const K& key) const {
+        return hash_code_equals(p, code, cache_hash()) && equals(get_key(p->value), key);
     }
-    size_type bkt_num_key(const key_type& key) const {
-        return bkt_num_key(key, buckets.size());
+
+    // 计算节点应该在哪个桶， p 是 bucket 数对应的策略
+    size_type bkt_num_node(const node* n, const BucketPolicy& p) const {
+        return p.index(node_hash(n));
     }
 
-    size_type bkt_num(const value_type& value) const {
-        return bkt_num_key(get_key(value));
+    // 新旧两个桶数组统一编号后的访问
+    size_type slot_count() const { return buckets.size() + old_buckets.size(); }
+    node*& slot(size_type i) {
+        return i < buckets.size() ? buckets[i] : old_buckets[i - buckets.size()];
     }
-    size_type bkt_num(const value_type& value, size_t n) const {
-        return bkt_num_key(get_key(value), n);
+    node* slot(size_type i) const {
+        return i < buckets.size() ? buckets[i] : old_buckets[i - buckets.size()];
     }
 
-    // 是否需要重建表格
-    void resize(size_type num_elements_hint);
-    // 在不需要重建表格的情况下插入新节点，键值不允许重复
-    std::pair<iterator, bool> insert_unique_noresize(const value_type& obj);
-    // 在不需要重建表格的情况下插入新节点，键值允许重复
-    iterator insert_equal_noresize(const value_type& obj);
+    template <class K>
+    node* find_in_chain(node* first, size_type code, const K& key) const {
+        while (first && !node_equals(first, code, key))
+            first = first->next;
+        return first;
+    }
+    template <class K>
+    size_type count_in_chain(const node* cur, size_type code, const K& key) const {
+        size_type res = 0;
+        for (; cur; cur = cur->next) {
+            if (node_equals(cur, code, key))
+                ++res;
+        }
+        return res;
+    }
+
+    // 查找 hash 值为 code 的 key， n 返回所在的桶(统一编号)， 搬迁期间新桶找不到时再找旧桶
+    template <class K>
+    node* find_node(const K& key, size_type code, size_type& n) const {
+        n = policy.index(code);
+        node* p = find_in_chain(buckets[n], code, key);
+        if (p == nullptr && is_rehashing()) {
+            const size_type old_n = old_policy.index(code);
+            p = find_in_chain(old_buckets[old_n], code, key);
+            n = buckets.size() + old_n;
+        }
+        return p;
+    }
+
+    // 从 first_bucket 往后找第一个非空桶， 表为空时返回 slot_count()
+    size_type skip_empty_buckets() const {
+        size_type n = first_bucket;
+        while (n < slot_count() && slot(n) == nullptr)
+            ++n;
+        return n;
+    }
+    // 删除之后调用， first_bucket 所在的桶被删空时后移到下一个非空桶
+    void advance_first_bucket() {
+        if (first_bucket < slot_count() && slot(first_bucket) == nullptr)
+            first_bucket = skip_empty_buckets();
+    }
+
+    // 表里没有相同 key 时放入新节点， 必要时扩容
+    iterator insert_new_node(node* p, size_type code) {
+        resize(num_elements + 1);
+        prepare_insert(code);
+        const size_type n = policy.index(code);
+        link_at_bucket(p, n);
+        ++num_elements;
+        return iterator(p, this, n);
+    }
 
+    // 在桶 n 的开头放入新节点
+    void link_at_bucket(node* p, size_type n) {
+        p->next = buckets[n];
+        buckets[n] = p;
+        if (n < first_bucket)
+            first_bucket = n;
+    }
+
+    template <class K>
+    size_type erase_in_chain(node*& first, size_type code, const K& key);
+
+    // 渐进式 rehash 相关
+    void start_rehash(size_type n);
+    void migrate_bucket(size_type old_n);
+    void rehash_step();
+    void finish_rehash();
+    // 插入前调用: 推进搬迁， 并把 key 所在的旧桶先搬过来， 之后只需要在新桶里找重复的 key
+    void prepare_insert(size_type code) {
+        if (is_rehashing()) {
+            rehash_step();
+            if (is_rehashing())
+                migrate_bucket(old_policy.index(code));
+        }
+    }
 
     void copy_from(const hashtable& ht);
 
 public:
     // 构造函数
     hashtable(size_type n, const HashFcn& hf, const EqualKey& eql)
-        : hash(hf), equals(eql), get_key(ExtractKey()), num_elements(0) {
+        : hash(hf), equals(eql), get_key(ExtractKey()), num_elements(0), policy(), first_bucket(0),
+          old_policy(), rehash_idx(0), rehash_batch(HASHTABLE_REHASH_STEP),
+          max_load(1.0f), min_load(0.0f), reserved(0), resize_callback(nullptr) {
         initialize_buckets(n);
     }
 
+    hashtable(const hashtable& ht)
+        : hash(ht.hash), equals(ht.equals), get_key(ht.get_key), num_elements(0), policy(), first_bucket(0),
+          old_policy(), rehash_idx(0), rehash_batch(ht.rehash_batch),
+          max_load(ht.max_load), min_load(ht.min_load), reserved(ht.reserved),
+          resize_callback(ht.resize_callback) {
+        copy_from(ht);
+    }
+
+    hashtable& operator=(const hashtable& ht) {
+        if (&ht != this) {
+            clear();
+            hash = ht.hash;
+            equals = ht.equals;
+            get_key = ht.get_key;
+            rehash_batch = ht.rehash_batch;
+            max_load = ht.max_load;
+            min_load = ht.min_load;
+            reserved = ht.reserved;
+            resize_callback = ht.resize_callback;
+            copy_from(ht);
+        }
+        return *this;
+    }
+
+    ~hashtable() { clear(); }
+
 };
 
-template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
-void hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::resize(size_type num_elements_hint) {
-    // 表格是否重建的判断原则， num_elements_hint > buckets.size 就重建
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
+void hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::resize(size_type num_elements_hint) {
+    // 表格是否重建的判断原则， num_elements_hint > buckets.size * max_load 就重建
     const size_type old_n = buckets.size();
-    if (num_elements_hint > old_n) {
+    if (num_elements_hint > static_cast<double>(old_n) * max_load) {
         // 找出下个质数
-        const size_type n = next_size(num_elements_hint);
+        const size_type n = next_size(buckets_for(num_elements_hint));
         if (n > old_n) {
-            mystl::vector<node*> tmp(n, nullptr);
-            try {
-                for(size_type bucket = 0; bucket < old_n; ++bucket) {
-                    node* first = buckets[bucket];
-                    while (first) {
-                        size_type new_bucket = bkt_num(first->value, n);
-                        // 以下4个操作
-                        // 1.旧的bucket指向下一个节点
-                        buckets[bucket] = first->next;
-                        // 2.3 将当前节点插入到新的bucket中
-                        first->next = tmp[new_bucket];
-                        tmp[new_bucket] = first;
-                        // 4. 回到旧bucket,准备处理下一个节点
-                        first = buckets[bucket];
-                    }
-                }
-                buckets.swap(tmp);
-            } catch (...) {
-                for (size_type bucket = 0; bucket < tmp.size(); ++bucket) {
-                    while (tmp[bucket]) {
-                        node* next = tmp[bucket]->next;
-                        delete_node(tmp[bucket]);
-                        tmp[bucket] = next;
-                    }
-                }
-                throw;
+            // 上一轮搬迁还没结束时先搬完， 同一时刻最多只有两个桶数组
+            complete_rehash();
+            if (rehash_batch != 0)
+                start_rehash(n);
+            else
+                rebuild(n);
+        }
+    }
+}
+
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
+void hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::rebuild(size_type n) {
+    const size_type old_n = buckets.size();
+    const __resize_timer timer(resize_callback, old_n);
+    bucket_array tmp(n);
+    BucketPolicy new_policy;
+    new_policy.reset(n);
+    size_type new_first = n;
+    try {
+        for(size_type bucket = 0; bucket < old_n; ++bucket) {
+            node* first = buckets[bucket];
+            while (first) {
+                size_type new_bucket = bkt_num_node(first, new_policy);
+                // 以下4个操作
+                // 1.旧的bucket指向下一个节点
+                buckets[bucket] = first->next;
+                // 2.3 将当前节点插入到新的bucket中
+                first->next = tmp[new_bucket];
+                tmp[new_bucket] = first;
+                if (new_bucket < new_first)
+                    new_first = new_bucket;
+                // 4. 回到旧bucket,准备处理下一个节点
+                first = buckets[bucket];
+            }
+        }
+        buckets.swap(tmp);
+        policy = new_policy;
+        first_bucket = new_first;
+    } catch (...) {
+        for (size_type bucket = 0; bucket < tmp.size(); ++bucket) {
+            while (tmp[bucket]) {
+                node* next = tmp[bucket]->next;
+                delete_node(tmp[bucket]);
+                tmp[bucket] = next;
             }
         }
+        throw;
     }
+    timer.done(n);
 }
 
-template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
-typename hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::iterator
-hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::insert_equal_noresize(const value_type &obj) {
-    const size_type n = bkt_num(obj);
+// 换上 n 个新桶， 原来的桶数组留作旧桶， 之后逐步搬迁
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
+void hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::start_rehash(size_type n) {
+    const __resize_timer timer(resize_callback, buckets.size());
+    bucket_array tmp(n);
+    old_buckets.swap(buckets);
+    buckets.swap(tmp);
+    old_policy = policy;
+    policy.reset(n);
+    rehash_idx = 0;
+    first_bucket += n; // 所有元素都在旧桶， 统一编号整体后移
+    timer.done(n);
+}
+
+// 把旧桶 old_n 里的节点全部挂到新桶， 只修改指针， 不分配内存
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
+void hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::migrate_bucket(size_type old_n) {
+    node*& first = old_buckets[old_n];
+    while (first) {
+        node* p = first;
+        first = p->next;
+        link_at_bucket(p, bkt_num_node(p, policy));
+    }
+}
+
+// 搬迁 rehash_batch 个非空旧桶， 和 Redis 一样最多跳过 10 倍个数的空桶， 避免单次操作耗时过长
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
+void hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::rehash_step() {
+    size_type empty_visits = rehash_batch * 10;
+    size_type moved = 0;
+    while (moved < rehash_batch && rehash_idx < old_buckets.size()) {
+        if (old_buckets[rehash_idx] == nullptr) {
+            ++rehash_idx;
+            if (--empty_visits == 0)
+                break;
+            continue;
+        }
+        migrate_bucket(rehash_idx++);
+        ++moved;
+    }
+    if (rehash_idx == old_buckets.size())
+        finish_rehash();
+}
+
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
+void hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::finish_rehash() {
+    if (!old_buckets.empty()) {
+        bucket_array().swap(old_buckets);
+        rehash_idx = 0;
+        // 节点都已挂到新桶， 挂入时 first_bucket 已经更新
+        if (first_bucket > buckets.size())
+            first_bucket = buckets.size();
+    }
+}
+
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
+typename hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::iterator
+hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::insert_equal_noresize(const value_type &obj) {
+    const size_type code = hash(get_key(obj));
+    prepare_insert(code);
+    const size_type n = policy.index(code);
     node* first = buckets[n];
     for (node* cur = first; cur; cur = cur->next) {
-        if (equals(get_key(cur->value), get_key(obj))) {
-            node* tmp = new_node(obj);
+        if (node_equals(cur, code, get_key(obj))) {
+            node* tmp = new_node(code, obj);
             tmp->next = cur->next;
             cur->next = tmp;
             ++num_elements;
-            return iterator(tmp, this);
+            return iterator(tmp, this, n);
         }
     }
-    node* tmp = new_node(obj);
-    tmp->next = first;
-    buckets[n] = tmp;
+    node* tmp = new_node(code, obj);
+    link_at_bucket(tmp, n);
     ++ num_elements;
-    return iterator(tmp, this);
+    return iterator(tmp, this, n);
 }
 
-template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
-std::pair<typename hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::iterator, bool>
-hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::insert_unique_noresize(const value_type &obj) {
-    const size_type n = bkt_num(obj);
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
+std::pair<typename hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::iterator, bool>
+hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::insert_unique_noresize(const value_type &obj) {
+    const size_type code = hash(get_key(obj));
+    prepare_insert(code);
+    const size_type n = policy.index(code);
     node* first = buckets[n];
     for (node* cur = first; cur; cur = cur->next) {
-        if (equals(get_key(cur->value), get_key(obj)))
-            return std::pair<iterator, bool>(iterator(cur, this), false);
+        if (node_equals(cur, code, get_key(obj)))
+            return std::pair<iterator, bool>(iterator(cur, this, n), false);
     }
-    node* tmp = new_node(obj);
-    tmp->next = first;
-    buckets[n] = tmp;
+    node* tmp = new_node(code, obj);
+    link_at_bucket(tmp, n);
     ++ num_elements;
-    return std::pair<iterator, bool>(iterator(tmp, this), true);
+    return std::pair<iterator, bool>(iterator(tmp, this, n), true);
 }
 
-template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
-void hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::clear() {
-    for(size_type i = 0; i < buckets.size(); ++i) {
-        node* cur = buckets[i];
+// 命中时不构造任何东西， 也不触发扩容
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
+template <class... Args>
+std::pair<typename hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::iterator, bool>
+hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::emplace_unique_key(const key_type& key,
+                                                                                       Args&&... args) {
+    const size_type code = hash(key);
+    size_type n;
+    if (node* p = find_node(key, code, n))
+        return std::pair<iterator, bool>(iterator(p, this, n), false);
+    node* tmp = new_node(code, mystl::forward<Args>(args)...);
+    try {
+        return std::pair<iterator, bool>(insert_new_node(tmp, code), true);
+    } catch (...) {
+        delete_node(tmp);
+        throw;
+    }
+}
+
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
+template <class... Args>
+std::pair<typename hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::iterator, bool>
+hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::emplace_unique(Args&&... args) {
+    node* tmp = new_node(0, mystl::forward<Args>(args)...);
+    try {
+        const size_type code = hash(get_key(tmp->value));
+        set_hash_code(tmp, code, cache_hash());
+        size_type n;
+        if (node* p = find_node(get_key(tmp->value), code, n)) {
+            delete_node(tmp);
+            return std::pair<iterator, bool>(iterator(p, this, n), false);
+        }
+        return std::pair<iterator, bool>(insert_new_node(tmp, code), true);
+    } catch (...) {
+        delete_node(tmp);
+        throw;
+    }
+}
+
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
+void hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::clear() {
+    for(size_type i = 0; i < slot_count(); ++i) {
+        node* cur = slot(i);
         while (cur) {
             node* next = cur->next;
             delete_node(cur);
             cur = next;
         }
-        buckets[i] = nullptr;
+        slot(i) = nullptr;
     }
     num_elements = 0;
+    finish_rehash();
+    first_bucket = buckets.size();
 }
 
-template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
-void hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::copy_from(const hashtable& ht) {
-    // 先清除己方的buckets vector
-    buckets.clear();
-    buckets.reserve(ht.buckets.size());
-    buckets.insert(buckets.end(), ht.buckets.size(), nullptr);
+// 第 k 个节点要比较 k 次， 长为 L 的链查找成功共比较 L(L+1)/2 次， 查找失败比较整条链
+// 渐进式 rehash 期间查找失败新旧两个桶都要看
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
+hashtable_stats hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::stats() const {
+    hashtable_stats res;
+    res.buckets = slot_count();
+    res.elements = num_elements;
+    res.begin_skips = skip_empty_buckets() - first_bucket;
+    size_type successful = 0;
+    size_type in_new = 0;
+    for (size_type i = 0; i < slot_count(); ++i) {
+        size_type len = 0;
+        for (const node* cur = slot(i); cur != nullptr; cur = cur->next)
+            ++len;
+        if (len == 0)
+            ++res.empty_buckets;
+        if (i < buckets.size())
+            in_new += len;
+        res.record(len);
+        successful += len * (len + 1) / 2;
+    }
+    double unsuccessful = static_cast<double>(in_new) / buckets.size();
+    if (is_rehashing())
+        unsuccessful += static_cast<double>(num_elements - in_new) / old_buckets.size();
+    res.finish(successful, unsuccessful);
+    return res;
+}
+
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
+void hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::copy_from(const hashtable& ht) {
+    // 换上和 ht 一样大的空桶数组， 原来的桶已经 clear 过
+    bucket_array(ht.buckets.size()).swap(buckets);
+    policy = ht.policy;
     try {
         for (size_type i = 0; i < ht.buckets.size(); ++i) {
             if (const node* cur = ht.buckets[i]) {
-                 node* copy = new_node(cur->value);
+                 node* copy = new_node(ht.node_hash(cur), cur->value);
                  buckets[i] = copy;
                  node* next = cur->next;
                  while (next) {
-                     copy->next = new_node(next->value);
+                     copy->next = new_node(ht.node_hash(next), next->value);
                      copy = copy->next;
                      cur = next;
                      next = cur->next;
                  }
             }
         }
+        // ht 正在搬迁时， 旧桶里的节点直接复制到新桶， 挂入时 first_bucket 再变小
+        first_bucket = ht.first_bucket < buckets.size() ? ht.first_bucket : buckets.size();
+        for (size_type i = 0; i < ht.old_buckets.size(); ++i) {
+            for (const node* cur = ht.old_buckets[i]; cur; cur = cur->next) {
+                const size_type code = ht.node_hash(cur);
+                link_at_bucket(new_node(code, cur->value), policy.index(code));
+            }
+        }
         num_elements = ht.num_elements;
     } catch (...) {
         clear();
@@ -449,17 +1029,18 @@ void hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::copy_from(const hasht
     }
 }
 
-template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
-typename hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::size_type
-hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::erase(const key_type& key) {
-    const size_type n = bkt_num_key(key);
-    node* first = buckets[n];
+// 删除链表 first 中所有等于 key 的节点
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
+template <class K>
+typename hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::size_type
+hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::erase_in_chain(node*& first, size_type code,
+                                                                                   const K& key) {
     size_type res = 0;
     if (first) {
         node* cur = first;
         node* next = cur->next; // 先从第二个处理
         while (next) {
-            if (equals(get_key(next->value), key)) {
+            if (node_equals(next, code, key)) {
                 cur->next = next->next;
                 delete_node(next);
                 next = cur->next;
@@ -470,9 +1051,10 @@ hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::erase(const key_type& key)
                 next = cur->next;
             }
         }
-        if (equals(get_key(first->value), key)) {
-            buckets[n] = first->next;
-            delete_node(first);
+        if (node_equals(first, code, key)) {
+            node* tmp = first;
+            first = first->next;
+            delete_node(tmp);
             ++res;
             --num_elements;
         }
@@ -481,14 +1063,14 @@ hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::erase(const key_type& key)
 }
 
 
-template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
-void hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::erase(const iterator& it) {
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
+void hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::erase(const iterator& it) {
     if (node* const p = it.cur) {
-        const size_type n = bkt_num(p->value);
-        node* cur = buckets[n];
+        node*& first = slot(it.bucket);
+        node* cur = first;
 
         if (cur == p) {
-            buckets[n] = cur->next;
+            first = cur->next;
             delete_node(cur);
             --num_elements;
         } else {
@@ -505,71 +1087,63 @@ void hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::erase(const iterator&
                 }
             }
         }
+        // 连续删除 begin() 时， 下一次 begin() 不用再扫一遍已经删空的桶
+        advance_first_bucket();
     }
 }
 
 
-template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
-typename hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::reference
-hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::find_or_insert(const value_type &obj) {
-    resize(num_elements + 1);
-    size_type n = bkt_num(obj);
-    node* first = buckets[n];
-
-    for(node* cur = first; cur; cur = cur->next)
-        if (equals(get_key(cur->value), get_key(obj)))
-            return cur->value;
-    node* tmp = new_node(obj);
-    tmp->next = first;
-    buckets[n] = tmp;
-    ++num_elements;
-    return tmp->value;
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
+typename hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::reference
+hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::find_or_insert(const value_type &obj) {
+    return emplace_unique_key(get_key(obj), obj).first->value;
 }
 
 
-template<class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
-hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey>&
-hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey>::operator++() {
-    const node* old = cur;
+// 链表走完后逐个检查后面的桶， 完整遍历一次仍是 O(size + 桶数)， first_bucket 只让 begin() 变快
+template<class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
+hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>&
+hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::operator++() {
     cur = cur->next;
     if (cur == nullptr) {
-        size_type bucket = ht->bkt_num(old->value);
-        while (cur == nullptr && ++bucket < ht->buckets.size())
-            cur = ht->buckets[bucket];
+        while (cur == nullptr && ++bucket < ht->slot_count())
+            cur = ht->slot(bucket);
     }
     return *this;
 }
 
-template<class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
-hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey>
-hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey>::operator++(int) {
+template<class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
+hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>
+hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::operator++(int) {
     iterator tmp = *this;
     ++*this;
     return tmp;
 }
 
 
-template<class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
-hashtable_const_iterator<Value, Key, HashFcn, ExtractKey, EqualKey>&
-hashtable_const_iterator<Value, Key, HashFcn, ExtractKey, EqualKey>::operator++() {
-    const node* old = cur;
+template<class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
+hashtable_const_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>&
+hashtable_const_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::operator++() {
     cur = cur->next;
     if (cur == nullptr) {
-        size_type bucket = ht->bkt_num(old->value);
-        while (cur == nullptr && ++bucket < ht->buckets.size())
-            cur = ht->buckets[bucket];
+        while (cur == nullptr && ++bucket < ht->slot_count())
+            cur = ht->slot(bucket);
     }
     return *this;
 }
 
-template<class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
-hashtable_const_iterator<Value, Key, HashFcn, ExtractKey, EqualKey>
-hashtable_const_iterator<Value, Key, HashFcn, ExtractKey, EqualKey>::operator++(int) {
-    iterator tmp = *this;
+template<class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class BucketPolicy>
+hashtable_const_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>
+hashtable_const_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, BucketPolicy>::operator++(int) {
+    const_iterator tmp = *this;
     ++*this;
     return tmp;
 }
 
+// bucket 数为 2 的幂次的 hashtable， 可以作为 hash_map/hash_set 的 HashTable 参数
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+using pow2_hashtable = hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, pow2_bucket_policy>;
+
 }
 
 #endif //FJXTINYSTL_HASHTABLE_H
@@ -0,0 +1,88 @@
+#ifndef FJXTINYSTL_HASHTABLE_STATS_H
+#define FJXTINYSTL_HASHTABLE_STATS_H
+
+//
+// Created by fengjiaxin on 2023/4/26.
+// hash 表的健康统计和扩容回调， hashtable， flat_hashtable， robin_hood_hashtable 共用
+// stats() 遍历一次整张表， O(桶数)， 用来排查 hash 函数分布不均， 不要放在热路径上
+// 开链法: 长度是桶里的节点数， histogram[i] 是长度为 i 的桶数
+// 开放寻址: 长度是找到元素要访问的槽数(flat_hashtable 按组计)， histogram[i] 是探测长度为 i 的元素数
+//
+
+#include <stddef.h>
+#include <stdint.h>
+#include <chrono>
+
+// 直方图的格数， 最后一格包含所有更长的
+#ifndef HASHTABLE_STATS_HISTOGRAM
+#define HASHTABLE_STATS_HISTOGRAM 16
+#endif
+
+namespace mystl
+{
+
+struct hashtable_stats {
+    size_t buckets;             // 桶数或槽数， 渐进式 rehash 期间包含旧桶
+    size_t elements;
+    size_t empty_buckets;
+    size_t tombstones;          // flat_hashtable 已删除的槽， 其他为 0
+    size_t begin_skips;         // hashtable 的 begin() 从记录的下界往后跳过的空桶数， 其他为 0
+    size_t max_chain;           // 最长的链或探测长度
+    double empty_ratio;         // empty_buckets / buckets
+    double avg_successful;      // 查找已有元素平均访问的节点/槽/组数
+    double avg_unsuccessful;    // 查找不存在的 key 平均访问的节点/槽/组数， 按 hash 值均匀分布计算
+    size_t histogram[HASHTABLE_STATS_HISTOGRAM];
+
+    hashtable_stats()
+        : buckets(0), elements(0), empty_buckets(0), tombstones(0), begin_skips(0), max_chain(0),
+          empty_ratio(0), avg_successful(0), avg_unsuccessful(0) {
+        for (size_t i = 0; i < HASHTABLE_STATS_HISTOGRAM; ++i)
+            histogram[i] = 0;
+    }
+
+    // 记录一个长度
+    void record(size_t len) {
+        ++histogram[len < HASHTABLE_STATS_HISTOGRAM ? len : HASHTABLE_STATS_HISTOGRAM - 1];
+        if (len > max_chain)
+            max_chain = len;
+    }
+
+    // successful_total: 把每个元素各查找一次访问的总数
+    void finish(size_t successful_total, double unsuccessful) {
+        empty_ratio = buckets == 0 ? 0 : static_cast<double>(empty_buckets) / buckets;
+        avg_successful = elements == 0 ? 0 : static_cast<double>(successful_total) / elements;
+        avg_unsuccessful = unsuccessful;
+    }
+};
+
+// 扩容(或收缩， 原地重建)后调用: 原来的桶数， 新的桶数， 耗时(纳秒)
+// 渐进式 rehash 只统计换上新桶数组的时间， 搬迁分摊在之后的插入里
+typedef void (*hashtable_resize_callback)(size_t old_buckets, size_t new_buckets, uint64_t nanoseconds);
+
+// 没有设置回调时不读时钟
+class __resize_timer {
+private:
+    typedef std::chrono::steady_clock clock;
+
+    hashtable_resize_callback callback;
+    size_t old_buckets;
+    clock::time_point start;
+
+public:
+    __resize_timer(hashtable_resize_callback cb, size_t old_n) : callback(cb), old_buckets(old_n) {
+        if (callback != nullptr)
+            start = clock::now();
+    }
+
+    void done(size_t new_n) const {
+        if (callback != nullptr) {
+            const uint64_t ns = static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count());
+            callback(old_buckets, new_n, ns);
+        }
+    }
+};
+
+}
+
+#endif //FJXTINYSTL_HASHTABLE_STATS_H
@@ -0,0 +1,193 @@
+#ifndef FJXTINYSTL_INTRUSIVE_LIST_H
+#define FJXTINYSTL_INTRUSIVE_LIST_H
+
+//
+// Created by fengjiaxin on 2023/4/23.
+// 侵入式双向链表， 链接指针(hook)嵌在元素里， 容器只把已有的对象串起来
+// 不分配任何内存， 也不拥有元素， 元素的生命周期由使用者管理
+// 哨兵 hook 在容器对象内部， 所以容器不能复制也不能移动
+// 用法: struct Task { intrusive_list_hook hook; ... };  intrusive_list<Task, &Task::hook> tasks;
+//
+
+#include <stddef.h>
+#include "iterator.h"
+
+namespace mystl
+{
+
+// 嵌在元素里的链接指针， 不在任何链表中时 prev/next 为 nullptr
+struct intrusive_list_hook {
+    intrusive_list_hook* prev;
+    intrusive_list_hook* next;
+
+    intrusive_list_hook() : prev(nullptr), next(nullptr) {}
+    // 复制对象不复制链接状态
+    intrusive_list_hook(const intrusive_list_hook&) : prev(nullptr), next(nullptr) {}
+    intrusive_list_hook& operator=(const intrusive_list_hook&) { return *this; }
+
+    bool is_linked() const { return next != nullptr; }
+};
+
+// hook 指针 <-> 元素指针， 通过 hook 成员在 T 内的偏移量换算
+template <class T, intrusive_list_hook T::*Hook>
+struct __intrusive_list_traits {
+    // 偏移量在第一次调用时从真实的元素 x 算出， 之后不变， 静态变量的初始化是线程安全的
+    // 只有 insert 过的 hook 才会换算回元素， insert 时已经用真实的元素算过， to_value 不会先于它调用
+    static size_t offset(const T* x) {
+        static const size_t off = reinterpret_cast<const char*>(&(x->*Hook)) - reinterpret_cast<const char*>(x);
+        return off;
+    }
+    static T* to_value(intrusive_list_hook* h) {
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(h) - offset(nullptr));
+    }
+    static intrusive_list_hook* to_hook(T* x) {
+        offset(x);
+        return &(x->*Hook);
+    }
+};
+
+// 迭代器类， 内部是指向 hook 的指针
+template <class T, intrusive_list_hook T::*Hook>
+struct __intrusive_list_iterator : public mystl::iterator<mystl::bidirectional_iterator_tag, T> {
+    typedef __intrusive_list_iterator<T, Hook>  self;
+    typedef __intrusive_list_traits<T, Hook>    traits;
+
+    typedef T                                   value_type;
+    typedef T*                                  pointer;
+    typedef T&                                  reference;
+    typedef intrusive_list_hook*                link_type;
+
+    link_type node;
+
+    __intrusive_list_iterator() : node(nullptr) {}
+    __intrusive_list_iterator(link_type x) : node(x) {}
+
+    bool operator==(const self& x) const { return node == x.node; }
+    bool operator!=(const self& x) const { return node != x.node; }
+
+    reference operator*() const { return *traits::to_value(node); }
+    pointer operator->() const { return traits::to_value(node); }
+
+    self& operator++() {
+        node = node->next;
+        return *this;
+    }
+    self operator++(int) {
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+    self& operator--() {
+        node = node->prev;
+        return *this;
+    }
+    self operator--(int) {
+        self tmp = *this;
+        --*this;
+        return tmp;
+    }
+};
+
+// 模板类: intrusive_list
+// 模板参数 T 代表元素类型， Hook 是 T 中 intrusive_list_hook 成员的指针
+template <class T, intrusive_list_hook T::*Hook>
+class intrusive_list
+{
+public:
+    typedef T                                   value_type;
+    typedef T*                                  pointer;
+    typedef T&                                  reference;
+    typedef const T&                            const_reference;
+    typedef size_t                              size_type;
+    typedef ptrdiff_t                           difference_type;
+
+    typedef __intrusive_list_iterator<T, Hook>  iterator;
+    typedef intrusive_list_hook*                link_type;
+
+private:
+    typedef __intrusive_list_traits<T, Hook>    traits;
+
+    intrusive_list_hook head_; // 哨兵， 指向末尾
+    size_type count_; // 元素个数
+
+public:
+    // 构造， 析构
+    intrusive_list() : count_(0) {
+        head_.prev = &head_;
+        head_.next = &head_;
+    }
+
+    intrusive_list(const intrusive_list&) = delete;
+    intrusive_list& operator=(const intrusive_list&) = delete;
+
+    // 析构时把所有元素摘下， 元素本身不受影响
+    ~intrusive_list() {
+        clear();
+    }
+
+public:
+    // 插入节点， 和 list::insert 的连接方式相同， x 不能已经在某个链表中
+    iterator insert(iterator position, reference x) {
+        link_type tmp = traits::to_hook(&x);
+        tmp->next = position.node;
+        tmp->prev = position.node->prev;
+        position.node->prev->next = tmp;
+        position.node->prev = tmp;
+        ++count_;
+        return tmp;
+    }
+
+    // 摘下节点， 返回下一个位置
+    iterator erase(iterator position) {
+        link_type next_node = position.node->next;
+        link_type prev_node = position.node->prev;
+        prev_node->next = next_node;
+        next_node->prev = prev_node;
+        position.node->prev = nullptr;
+        position.node->next = nullptr;
+        --count_;
+        return next_node;
+    }
+
+    // 通过元素的引用直接摘下， O(1)
+    iterator erase(reference x) {
+        return erase(iterator_to(x));
+    }
+
+    void clear() {
+        link_type cur = head_.next;
+        while (cur != &head_) {
+            link_type tmp = cur;
+            cur = cur->next;
+            tmp->prev = nullptr;
+            tmp->next = nullptr;
+        }
+        head_.next = &head_;
+        head_.prev = &head_;
+        count_ = 0;
+    }
+
+public:
+    // 迭代器相关操作
+    iterator begin() noexcept { return head_.next; }
+    iterator end() noexcept { return &head_; }
+    // 元素 -> 迭代器， x 必须在本链表中
+    iterator iterator_to(reference x) { return traits::to_hook(&x); }
+
+    // 容器相关操作
+    bool empty() const noexcept { return head_.next == &head_; }
+    size_type size() const noexcept { return count_; }
+
+    // 访问元素相关操作
+    reference front() { return *begin(); }
+    reference back() { return *(--end()); }
+
+    void push_front(reference x) { insert(begin(), x); }
+    void push_back(reference x) { insert(end(), x); }
+    void pop_front() { erase(begin()); }
+    void pop_back() { erase(--end()); }
+};
+
+}
+
+#endif //FJXTINYSTL_INTRUSIVE_LIST_H
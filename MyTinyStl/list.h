@@ -2,6 +2,8 @@
 // Created by fengjiaxin on 2023/4/10.
 // 双向链表, 主要完成下面几个方法
 // push_back, push_front, pop_front, pop_back, insert, erase
+// splice, merge, reverse, remove_if, sort 只重新连接节点， 不复制元素也不分配内存
+// 元素个数单独记录， size() 为 O(1)
 //
 
 #ifndef FJXTINYSTL_LIST_H
@@ -10,6 +12,7 @@
 #include "iterator.h"
 #include <stddef.h>
 #include "allocator.h"
+#include "functional.h"
 
 namespace mystl
 {
@@ -41,6 +44,7 @@ struct __list_iterator : public mystl::iterator<mystl::bidirectional_iterator_ta
     __list_iterator() {}
     __list_iterator(link_type x): node(x) {} // iterator接受一个指向node节点的指针进行初始化
     __list_iterator(const self& x) : node(x.node) {}
+    self& operator=(const self&) = default;
 
     bool operator==(const self& x) const { return node == x.node; }
     bool operator!=(const self& x) const { return node != x.node; }
@@ -72,6 +76,7 @@ struct __list_iterator : public mystl::iterator<mystl::bidirectional_iterator_ta
     self operator--(int) {
         self tmp = *this;
         --*this;
+        return tmp;
     }
 };
 
@@ -99,6 +104,7 @@ public:
 
 private:
     link_type node_ = nullptr; // 指向末尾节点
+    size_type count_ = 0; // 元素个数
 
 public:
     // 构造，复制，移动，析构函数
@@ -141,6 +147,7 @@ public:
         tmp->prev = position.node->prev;
         position.node->prev->next = tmp;
         position.node->prev = tmp;
+        ++count_;
         return tmp;
     }
 
@@ -157,6 +164,7 @@ public:
         prev_node->next = next_node;
         next_node->prev = prev_node;
         destroy_node(position.node);
+        --count_;
         return next_node;
     }
 
@@ -169,6 +177,153 @@ public:
         }
         node_->next = node_;
         node_->prev = node_;
+        count_ = 0;
+    }
+
+public:
+    // 把 x 的所有元素接到 position 之前， x 变为空
+    void splice(iterator position, list& x) {
+        if (!x.empty()) {
+            transfer(position, x.begin(), x.end());
+            count_ += x.count_;
+            x.count_ = 0;
+        }
+    }
+
+    // 把 i 所指的元素接到 position 之前， i 可以来自同一个 list
+    void splice(iterator position, list& x, iterator i) {
+        iterator j = i;
+        ++j;
+        if (position == i || position == j)
+            return;
+        transfer(position, i, j);
+        ++count_;
+        --x.count_;
+    }
+
+    // 把 [first, last) 接到 position 之前， position 不能位于 [first, last) 内
+    // 来自另一个 list 时需要数一遍区间长度
+    void splice(iterator position, list& x, iterator first, iterator last) {
+        if (first == last)
+            return;
+        if (&x != this) {
+            const size_type n = static_cast<size_type>(mystl::distance(first, last));
+            count_ += n;
+            x.count_ -= n;
+        }
+        transfer(position, first, last);
+    }
+
+    // 两个 list 都已递增排序， 把 x 合并进来， x 变为空
+    void merge(list& x) {
+        merge(x, mystl::less<T>());
+    }
+
+    template <class Compare>
+    void merge(list& x, Compare comp) {
+        if (&x == this)
+            return;
+        iterator first1 = begin();
+        iterator last1 = end();
+        iterator first2 = x.begin();
+        iterator last2 = x.end();
+        while (first1 != last1 && first2 != last2) {
+            if (comp(*first2, *first1)) {
+                iterator next = first2;
+                transfer(first1, first2, ++next);
+                first2 = next;
+            } else {
+                ++first1;
+            }
+        }
+        if (first2 != last2)
+            transfer(last1, first2, last2);
+        count_ += x.count_;
+        x.count_ = 0;
+    }
+
+    // 逆序， 交换每个节点的 prev/next
+    void reverse() {
+        link_type cur = node_;
+        do {
+            link_type tmp = cur->next;
+            cur->next = cur->prev;
+            cur->prev = tmp;
+            cur = tmp;
+        } while (cur != node_);
+    }
+
+    // 删除满足 pred 的元素
+    template <class Predicate>
+    void remove_if(Predicate pred) {
+        iterator first = begin();
+        iterator last = end();
+        while (first != last) {
+            iterator next = first;
+            ++next;
+            if (pred(*first))
+                erase(first);
+            first = next;
+        }
+    }
+
+    // 稳定排序， 即 SGI 的 64 个桶的自底向上归并排序
+    // 桶里放以 nullptr 结尾的单链表， 不需要临时 list 的哨兵节点， 完全不分配内存， 最后统一修复 prev
+    void sort() {
+        sort(mystl::less<T>());
+    }
+
+    template <class Compare>
+    void sort(Compare comp) {
+        if (count_ < 2)
+            return;
+        link_type bins[64] = {};
+        int fill = 0;
+        node_->prev->next = nullptr;
+        link_type cur = node_->next;
+        link_type carry = nullptr;
+        link_type result = nullptr;
+        try {
+            while (cur != nullptr) {
+                carry = cur;
+                cur = cur->next;
+                carry->next = nullptr;
+                int i = 0;
+                for (; i < fill && bins[i] != nullptr; ++i) {
+                    link_type newer = carry;
+                    carry = nullptr;
+                    merge_chain(bins[i], newer, comp);
+                    carry = bins[i];
+                    bins[i] = nullptr;
+                }
+                bins[i] = carry;
+                carry = nullptr;
+                if (i == fill)
+                    ++fill;
+            }
+            for (int i = 0; i < fill; ++i) {
+                if (bins[i] != nullptr) {
+                    link_type newer = result;
+                    result = nullptr;
+                    merge_chain(bins[i], newer, comp);
+                    result = bins[i];
+                    bins[i] = nullptr;
+                }
+            }
+        } catch (...) {
+            // comp 抛出异常， 把所有节点按任意顺序接回来， 元素不丢失
+            link_type all = nullptr;
+            link_type* tail = &all;
+            link_type chains[3] = {cur, carry, result};
+            for (int i = 0; i < 3 + fill; ++i) {
+                *tail = i < 3 ? chains[i] : bins[i - 3];
+                while (*tail != nullptr)
+                    tail = &(*tail)->next;
+            }
+            relink_chain(all);
+            throw;
+        }
+        relink_chain(result);
     }
 
 public:
@@ -185,9 +340,8 @@ public:
     bool empty() const noexcept {
         return node_->next == node_;
     }
-    typename mystl::iterator_traits<iterator>::difference_type
-    size() noexcept {
-        return mystl::distance<iterator>(begin(), end());
+    size_type size() const noexcept {
+        return count_;
     }
 
     // 访问元素相关操作
@@ -242,6 +396,57 @@ private:
         release_node(p);
     }
 
+private:
+    // 把 [first, last) 内的节点移到 position 之前， 不维护 count_, 由调用者负责
+    void transfer(iterator position, iterator first, iterator last) {
+        if (position != last) {
+            last.node->prev->next = position.node;
+            first.node->prev->next = last.node;
+            position.node->prev->next = first.node;
+            link_type tmp = position.node->prev;
+            position.node->prev = last.node->prev;
+            last.node->prev = first.node->prev;
+            first.node->prev = tmp;
+        }
+    }
+
+    // 把较新的有序单链表 b 合并进较旧的 a, 相等时 a 的元素在前
+    // comp 抛出异常时 b 剩下的节点接在 a 的末尾， 所有节点仍然在 a 上
+    template <class Compare>
+    static void merge_chain(link_type& a, link_type b, Compare comp) {
+        link_type* tail = &a;
+        try {
+            while (*tail != nullptr && b != nullptr) {
+                if (comp(b->data, (*tail)->data)) {
+                    link_type next = b->next;
+                    b->next = *tail;
+                    *tail = b;
+                    b = next;
+                }
+                tail = &(*tail)->next;
+            }
+        } catch (...) {
+            while (*tail != nullptr)
+                tail = &(*tail)->next;
+            *tail = b;
+            throw;
+        }
+        if (b != nullptr)
+            *tail = b;
+    }
+
+    // 用以 first 开头的单链表重建整个环， 修复 prev
+    void relink_chain(link_type first) {
+        link_type prev = node_;
+        for (link_type p = first; p != nullptr; p = p->next) {
+            p->prev = prev;
+            prev->next = p;
+            prev = p;
+        }
+        prev->next = node_;
+        node_->prev = prev;
+    }
+
 private:
     // 初始化 相关操作
     void empty_initialize() {
@@ -0,0 +1,265 @@
+#ifndef FJXTINYSTL_RING_BUFFER_H
+#define FJXTINYSTL_RING_BUFFER_H
+
+//
+// Created by fengjiaxin on 2023/4/22.
+// ring_buffer, 环形缓冲区, 容量总是 2 的幂次, 下标通过 & mask 计算
+// 元素在内存中最多分成两段连续区间， 可以通过 array_one()/array_two() 直接访问
+// 可以指定固定容量， 满了以后再 push_back 会覆盖最旧的元素
+// 提供 push_back/pop_front/push_front/pop_back/front/back, 可以作为 queue 和 stack 的底层容器
+//
+
+#include <utility>
+#include <stdexcept>
+#include "iterator.h"
+#include "allocator.h"
+#include "construct.h"
+#include "util.h"
+
+namespace mystl
+{
+
+// ring_buffer 的初始容量
+#ifndef RING_BUFFER_INIT_SIZE
+#define RING_BUFFER_INIT_SIZE 16
+#endif
+
+// 固定容量的开关， 作为 ring_buffer 构造函数的额外参数传入
+struct fixed_capacity_t {};
+constexpr fixed_capacity_t fixed_capacity{};
+
+// 不小于 n 的最小 2 的幂次
+inline size_t __ring_round_up(size_t n) {
+    size_t res = 1;
+    while (res < n)
+        res <<= 1;
+    return res;
+}
+
+// ring_buffer 的迭代器， 记录缓冲区、 mask、 头部位置和逻辑下标
+template <class T, class Ref, class Ptr>
+struct __ring_buffer_iterator : public iterator<mystl::random_access_iterator_tag, T>
+{
+    typedef __ring_buffer_iterator<T, T&, T*>              iterator;
+    typedef __ring_buffer_iterator<T, const T&, const T*>  const_iterator;
+    typedef __ring_buffer_iterator                         self;
+
+    typedef T           value_type;
+    typedef Ptr         pointer;
+    typedef Ref         reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+
+    T*        buf;
+    size_type mask;
+    size_type head;
+    size_type pos;
+
+    __ring_buffer_iterator() noexcept : buf(nullptr), mask(0), head(0), pos(0) {}
+    __ring_buffer_iterator(T* b, size_type m, size_type h, size_type n) : buf(b), mask(m), head(h), pos(n) {}
+    __ring_buffer_iterator(const iterator& rhs) : buf(rhs.buf), mask(rhs.mask), head(rhs.head), pos(rhs.pos) {}
+    self& operator=(const self&) = default;
+
+    reference operator*() const { return buf[(head + pos) & mask]; }
+    pointer   operator->() const { return &(operator*()); }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    self& operator++() { ++pos; return *this; }
+    self operator++(int) {
+        self tmp = *this;
+        ++pos;
+        return tmp;
+    }
+    self& operator--() { --pos; return *this; }
+    self operator--(int) {
+        self tmp = *this;
+        --pos;
+        return tmp;
+    }
+
+    self& operator+=(difference_type n) { pos += n; return *this; }
+    self& operator-=(difference_type n) { pos -= n; return *this; }
+    self operator+(difference_type n) const { return self(buf, mask, head, pos + n); }
+    self operator-(difference_type n) const { return self(buf, mask, head, pos - n); }
+    difference_type operator-(const self& x) const {
+        return static_cast<difference_type>(pos) - static_cast<difference_type>(x.pos);
+    }
+
+    bool operator==(const self& rhs) const { return pos == rhs.pos; }
+    bool operator!=(const self& rhs) const { return pos != rhs.pos; }
+    bool operator< (const self& rhs) const { return pos < rhs.pos; }
+    bool operator> (const self& rhs) const { return rhs < *this; }
+    bool operator<=(const self& rhs) const { return !(rhs < *this); }
+    bool operator>=(const self& rhs) const { return !(*this < rhs); }
+};
+
+template <class T>
+class ring_buffer
+{
+public:
+    typedef mystl::allocator<T>                      allocator_type;
+    typedef mystl::allocator<T>                      data_allocator;
+
+    typedef typename allocator_type::value_type      value_type;
+    typedef typename allocator_type::pointer         pointer;
+    typedef typename allocator_type::const_pointer   const_pointer;
+    typedef typename allocator_type::reference       reference;
+    typedef typename allocator_type::const_reference const_reference;
+    typedef typename allocator_type::size_type       size_type;
+    typedef typename allocator_type::difference_type difference_type;
+
+    typedef __ring_buffer_iterator<T, T&, T*>              iterator;
+    typedef __ring_buffer_iterator<T, const T&, const T*>  const_iterator;
+
+private:
+    pointer   buf;    // 缓冲区
+    size_type cap;    // 缓冲区大小， 0 或 2 的幂次
+    size_type head;   // 第一个元素的位置
+    size_type count;  // 元素个数
+    size_type limit;  // 固定容量， 0 表示容量可以增长
+
+public:
+    // 构造， 析构
+    ring_buffer() : buf(nullptr), cap(0), head(0), count(0), limit(0) {}
+
+    // 预留 n 个元素的空间， 容量仍可增长
+    explicit ring_buffer(size_type n) : ring_buffer() {
+        reallocate(mystl::__ring_round_up(n));
+    }
+
+    // 固定容量为 n, 满了以后 push_back 覆盖最旧的元素， push_front 覆盖最新的元素
+    // limit 为 0 表示可以增长， 所以固定容量不能为 0
+    ring_buffer(size_type n, fixed_capacity_t) : ring_buffer() {
+        if (n == 0)
+            throw std::length_error("ring_buffer: fixed capacity must be positive");
+        reallocate(mystl::__ring_round_up(n));
+        limit = n;
+    }
+
+    ring_buffer(const ring_buffer&) = delete;
+    ring_buffer& operator=(const ring_buffer&) = delete;
+
+    ~ring_buffer() {
+        clear();
+        data_allocator::deallocate(buf, cap);
+    }
+
+public:
+    // 迭代器相关操作
+    iterator begin() { return iterator(buf, cap - 1, head, 0); }
+    iterator end() { return iterator(buf, cap - 1, head, count); }
+    const_iterator begin() const { return const_iterator(buf, cap - 1, head, 0); }
+    const_iterator end() const { return const_iterator(buf, cap - 1, head, count); }
+
+    // 容量相关操作
+    size_type size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_type capacity() const { return limit != 0 ? limit : cap; }
+    bool full() const { return limit != 0 && count == limit; }
+
+    // 两段连续区间， 第一段从最旧的元素开始
+    std::pair<pointer, size_type> array_one() {
+        const size_type len = head + count > cap ? cap - head : count;
+        return std::pair<pointer, size_type>(buf + head, len);
+    }
+    std::pair<pointer, size_type> array_two() {
+        const size_type len = head + count > cap ? head + count - cap : 0;
+        return std::pair<pointer, size_type>(buf, len);
+    }
+
+    // 访问元素相关操作
+    reference operator[](size_type n) { return buf[(head + n) & (cap - 1)]; }
+    const_reference operator[](size_type n) const { return buf[(head + n) & (cap - 1)]; }
+    reference front() { return buf[head]; }
+    const_reference front() const { return buf[head]; }
+    reference back() { return (*this)[count - 1]; }
+    const_reference back() const { return (*this)[count - 1]; }
+
+public:
+    // emplace_*, push_*, pop_*
+    template <class... Args>
+    void emplace_back(Args&&... args) {
+        if (count == cap || full()) {
+            // 参数可能引用容器内的元素， 先构造出来再腾位置
+            value_type x_copy(mystl::forward<Args>(args)...);
+            make_room(true);
+            mystl::construct(buf + ((head + count) & (cap - 1)), mystl::move(x_copy));
+        } else {
+            mystl::construct(buf + ((head + count) & (cap - 1)), mystl::forward<Args>(args)...);
+        }
+        ++count;
+    }
+
+    template <class... Args>
+    void emplace_front(Args&&... args) {
+        if (count == cap || full()) {
+            value_type x_copy(mystl::forward<Args>(args)...);
+            make_room(false);
+            mystl::construct(buf + ((head - 1) & (cap - 1)), mystl::move(x_copy));
+        } else {
+            mystl::construct(buf + ((head - 1) & (cap - 1)), mystl::forward<Args>(args)...);
+        }
+        head = (head - 1) & (cap - 1);
+        ++count;
+    }
+
+    void push_back(const value_type& x) { emplace_back(x); }
+    void push_back(value_type&& x) { emplace_back(mystl::move(x)); }
+    void push_front(const value_type& x) { emplace_front(x); }
+    void push_front(value_type&& x) { emplace_front(mystl::move(x)); }
+
+    void pop_front() {
+        mystl::destroy(buf + head);
+        head = (head + 1) & (cap - 1);
+        --count;
+    }
+
+    void pop_back() {
+        --count;
+        mystl::destroy(buf + ((head + count) & (cap - 1)));
+    }
+
+    void clear() {
+        while (count > 0)
+            pop_back();
+        head = 0;
+    }
+
+private:
+    // 满了： 固定容量时丢掉另一端的元素， 否则容量翻倍
+    void make_room(bool at_back) {
+        if (full()) {
+            if (at_back)
+                pop_front();
+            else
+                pop_back();
+        } else {
+            reallocate(cap != 0 ? cap * 2 : RING_BUFFER_INIT_SIZE);
+        }
+    }
+
+    // 换一块大小为 new_cap 的缓冲区， 元素按顺序搬到开头
+    void reallocate(size_type new_cap) {
+        pointer new_buf = data_allocator::allocate(new_cap);
+        size_type i = 0;
+        try {
+            for (; i < count; ++i)
+                mystl::construct(new_buf + i, mystl::move((*this)[i]));
+        } catch (...) {
+            for (size_type j = 0; j < i; ++j)
+                mystl::destroy(new_buf + j);
+            data_allocator::deallocate(new_buf, new_cap);
+            throw;
+        }
+        for (size_type j = 0; j < count; ++j)
+            mystl::destroy(&(*this)[j]);
+        data_allocator::deallocate(buf, cap);
+        buf = new_buf;
+        cap = new_cap;
+        head = 0;
+    }
+};
+
+}
+
+#endif //FJXTINYSTL_RING_BUFFER_H
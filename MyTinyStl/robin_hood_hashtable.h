@@ -0,0 +1,526 @@
+#ifndef FJXTINYSTL_ROBIN_HOOD_HASHTABLE_H
+#define FJXTINYSTL_ROBIN_HOOD_HASHTABLE_H
+
+//
+// Created by fengjiaxin on 2023/4/25.
+// Robin Hood 开放寻址 hash 表， 接口和 hashtable 相同， 可以作为 hash_map/hash_set 的底层
+// 1. 元素直接存放在槽数组里， 线性探测， 每个槽带 1 个字节记录探测距离 + 1(0 表示空槽)
+//    探测距离和元素放在一起， 查找一个 key 通常只访问一条 cache line
+// 2. 插入时 "劫富济贫": 新元素离理想位置更远时占据当前槽， 原来的元素整体后移一格
+//    所以同一个理想位置出发的元素总是连续的， 探测距离的方差很小
+// 3. 查找时一旦当前槽的探测距离小于已走的距离， key 就不可能在更后面， 提前结束
+// 4. 删除时把后面的元素整体前移一格(backward shift)， 不留墓碑， 删除多了查找也不会变慢
+// 5. 插入和删除会移动其他元素， 使迭代器失效
+//    移动构造抛出异常时表仍然有效: 插入时撤销已经做的移动， 之后重新抛出， 元素不变;
+//    撤销或删除时的移动也抛出异常， 就析构这一段里剩下需要移动的元素， 这些元素会丢失
+//    hash_map 的元素是 pair<const Key, T>， 移动时 key 实际是复制， key 的复制可能抛出异常
+// 6. 探测距离最多 255， 超过时扩容; 同一个 hash 值的元素太多(例如大量重复 key)时抛出 length_error
+//
+
+#include <stdint.h>
+#include <string.h>
+#include <utility>
+#include <stdexcept>
+#include "iterator.h"
+#include "allocator.h"
+#include "construct.h"
+#include "util.h"
+#include "hash_fun.h"
+#include "hashtable_stats.h"
+#include "flat_hashtable.h"
+
+namespace mystl
+{
+
+// 槽: 探测距离 + 1(0 表示空槽)和元素， 只有 dist 不为 0 时 value 才被构造
+template <class Value>
+struct robin_hood_slot {
+    uint8_t dist;
+    Value value;
+};
+
+template <class Value, class Ref, class Ptr>
+struct robin_hood_hashtable_iterator : public mystl::iterator<mystl::forward_iterator_tag, Value> {
+    typedef robin_hood_hashtable_iterator<Value, Value&, Value*>              iterator;
+    typedef robin_hood_hashtable_iterator<Value, const Value&, const Value*>  const_iterator;
+    typedef robin_hood_hashtable_iterator                                     self;
+
+    typedef Value       value_type;
+    typedef Ref         reference;
+    typedef Ptr         pointer;
+    typedef ptrdiff_t   difference_type;
+    typedef size_t      size_type;
+    typedef robin_hood_slot<Value> slot_type;
+
+    slot_type* cur;
+
+    robin_hood_hashtable_iterator() : cur(nullptr) {}
+    explicit robin_hood_hashtable_iterator(slot_type* s) : cur(s) {}
+    robin_hood_hashtable_iterator(const iterator& it) : cur(it.cur) {}
+    self& operator=(const self&) = default;
+
+    reference operator*() const { return cur->value; }
+    pointer operator->() const { return &(operator*()); }
+
+    bool operator==(const self& it) const { return cur == it.cur; }
+    bool operator!=(const self& it) const { return cur != it.cur; }
+
+    self& operator++() {
+        ++cur;
+        skip_empty();
+        return *this;
+    }
+    self operator++(int) {
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    // 跳到下一个满的槽， 末尾 sentinel 槽的 dist 不为 0
+    void skip_empty() {
+        while (cur->dist == 0)
+            ++cur;
+    }
+};
+
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+class robin_hood_hashtable {
+public:
+    typedef Key  key_type;
+    typedef Value value_type;
+    typedef HashFcn hasher;
+    typedef EqualKey key_equal;
+
+    typedef size_t  size_type;
+    typedef ptrdiff_t difference_type;
+    typedef value_type* pointer;
+    typedef const value_type* const_pointer;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+
+    typedef robin_hood_hashtable_iterator<Value, Value&, Value*>              iterator;
+    typedef robin_hood_hashtable_iterator<Value, const Value&, const Value*>  const_iterator;
+
+    hasher hash_func() const { return hash; }
+    key_equal key_eq() const { return equals; }
+
+private:
+    typedef robin_hood_slot<Value>           slot_type;
+    typedef mystl::allocator<slot_type>      slot_allocator;
+
+    static const uint8_t max_dist = 255;
+
+    hasher  hash;
+    key_equal equals;
+    ExtractKey get_key;
+    slot_type* slots;       // capacity + 1 个槽， 最后一个是 sentinel
+    size_type capacity;     // 槽数， 2 的幂次
+    size_type num_elements;
+    hashtable_resize_callback resize_callback; // rehash 后调用， 默认为空
+
+public:
+    // 构造， 复制， 析构
+    robin_hood_hashtable(size_type n, const HashFcn& hf, const EqualKey& eql)
+        : hash(hf), equals(eql), get_key(ExtractKey()), slots(nullptr), capacity(0), num_elements(0),
+          resize_callback(nullptr) {
+        initialize_slots(capacity_for(n));
+    }
+
+    robin_hood_hashtable(const robin_hood_hashtable& ht)
+        : hash(ht.hash), equals(ht.equals), get_key(ht.get_key), slots(nullptr), capacity(0), num_elements(0),
+          resize_callback(ht.resize_callback) {
+        copy_from(ht);
+    }
+
+    robin_hood_hashtable& operator=(const robin_hood_hashtable& ht) {
+        if (&ht != this) {
+            robin_hood_hashtable tmp(ht);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    ~robin_hood_hashtable() {
+        destroy_slots();
+    }
+
+public:
+    // 和容量相关的查询
+    size_type size() const { return num_elements; }
+    bool empty() const { return num_elements == 0; }
+    void swap(robin_hood_hashtable& ht) {
+        mystl::swap(hash, ht.hash);
+        mystl::swap(equals, ht.equals);
+        mystl::swap(get_key, ht.get_key);
+        mystl::swap(slots, ht.slots);
+        mystl::swap(capacity, ht.capacity);
+        mystl::swap(num_elements, ht.num_elements);
+        mystl::swap(resize_callback, ht.resize_callback);
+    }
+
+    // 查询边界
+    iterator begin() {
+        iterator it(slots);
+        it.skip_empty();
+        return it;
+    }
+    const_iterator begin() const {
+        const_iterator it(slots);
+        it.skip_empty();
+        return it;
+    }
+    iterator end() { return iterator(slots + capacity); }
+    const_iterator end() const { return const_iterator(slots + capacity); }
+
+public:
+    // 和 bucket 相关的查询， 每个槽看作一个 bucket
+    size_type bucket_count() const { return capacity; }
+    size_type max_bucket_count() const { return static_cast<size_type>(1) << (sizeof(size_type) * 8 - 2); }
+    size_type elems_in_bucket(size_type bucket) const { return slots[bucket].dist != 0 ? 1 : 0; }
+
+    // 插入元素， 不允许重复
+    std::pair<iterator, bool> insert_unique(const value_type& obj) {
+        return insert_unique_noresize(obj);
+    }
+    // 插入元素， 允许重复
+    iterator insert_equal(const value_type& obj) {
+        return insert_equal_noresize(obj);
+    }
+
+    // 开放寻址没有空槽时必须扩容， 所以 noresize 版本在负载达到 7/8 时同样会扩容
+    std::pair<iterator, bool> insert_unique_noresize(const value_type& obj) {
+        return emplace_unique_key(get_key(obj), obj);
+    }
+    iterator insert_equal_noresize(const value_type& obj) {
+        return iterator_at(insert_at(hash_of(get_key(obj)), obj));
+    }
+
+    reference find_or_insert(const value_type& obj) {
+        return *insert_unique_noresize(obj).first;
+    }
+
+    // 先按 key 查找， 找不到时才用 args 构造元素
+    template <class... Args>
+    std::pair<iterator, bool> emplace_unique_key(const key_type& key, Args&&... args) {
+        const size_type h = hash_of(key);
+        const size_type i = find_index(key, h);
+        if (i != capacity)
+            return std::pair<iterator, bool>(iterator_at(i), false);
+        return std::pair<iterator, bool>(iterator_at(insert_at(h, mystl::forward<Args>(args)...)), true);
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> emplace_unique(Args&&... args) {
+        value_type x(mystl::forward<Args>(args)...);
+        return emplace_unique_key(get_key(x), mystl::move(x));
+    }
+
+    iterator find(const key_type& key) { return find_key(key); }
+    const_iterator find(const key_type& key) const { return find_key(key); }
+    size_type count(const key_type& key) const { return count_key(key); }
+    size_type erase(const key_type& key) { return erase_key(key); }
+
+    // 异构查找: HashFcn 和 EqualKey 都带有 is_transparent 时， key 可以是任何能和 key_type 一起 hash/比较的类型
+    template <class K, class H = HashFcn, class E = EqualKey>
+    typename __if_transparent<H, E, iterator>::type find(const K& key) { return find_key(key); }
+    template <class K, class H = HashFcn, class E = EqualKey>
+    typename __if_transparent<H, E, const_iterator>::type find(const K& key) const { return find_key(key); }
+    template <class K, class H = HashFcn, class E = EqualKey>
+    typename __if_transparent<H, E, size_type>::type count(const K& key) const { return count_key(key); }
+    template <class K, class H = HashFcn, class E = EqualKey>
+    typename __if_transparent<H, E, size_type>::type erase(const K& key) { return erase_key(key); }
+
+    // 后面的元素会前移， 其他迭代器失效
+    void erase(const iterator& it) {
+        if (it != end())
+            erase_at(static_cast<size_type>(it.cur - slots));
+    }
+
+    // 析构所有元素， 保留槽数组
+    void clear() {
+        for (size_type i = 0; i < capacity; ++i) {
+            if (slots[i].dist != 0) {
+                mystl::destroy(&slots[i].value);
+                slots[i].dist = 0;
+            }
+        }
+        num_elements = 0;
+    }
+
+    // 保证能放下 num_elements_hint 个元素而不扩容
+    void resize(size_type num_elements_hint) {
+        if (num_elements_hint > max_load(capacity))
+            rehash(capacity_for(num_elements_hint));
+    }
+
+    // 探测长度直方图， 最长探测长度， 空槽比例， 查找成功/失败平均访问的槽数， 遍历所有槽
+    hashtable_stats stats() const;
+    // 扩容后调用 cb， 传 nullptr 取消
+    void set_resize_callback(hashtable_resize_callback cb) { resize_callback = cb; }
+
+private:
+    static size_type max_load(size_type cap) { return cap - cap / 8; }
+    static size_type capacity_for(size_type n) {
+        size_type cap = 8;
+        while (max_load(cap) < n)
+            cap <<= 1;
+        return cap;
+    }
+
+    template <class K>
+    size_type hash_of(const K& key) const { return mystl::__flat_mix(hash(key)); }
+    size_type mask() const { return capacity - 1; }
+
+    iterator iterator_at(size_type i) { return iterator(slots + i); }
+
+    void initialize_slots(size_type cap) {
+        if (cap > max_bucket_count())
+            throw std::length_error("robin_hood_hashtable: too many buckets");
+        slots = slot_allocator::allocate(cap + 1);
+        capacity = cap;
+        for (size_type i = 0; i < cap; ++i)
+            slots[i].dist = 0;
+        slots[cap].dist = 1; // sentinel
+    }
+
+    void destroy_slots() {
+        if (slots == nullptr)
+            return;
+        clear();
+        slot_allocator::deallocate(slots, capacity + 1);
+        slots = nullptr;
+    }
+
+    template <class K>
+    iterator find_key(const K& key) {
+        return iterator_at(find_index(key, hash_of(key)));
+    }
+    template <class K>
+    const_iterator find_key(const K& key) const {
+        return const_iterator(slots + find_index(key, hash_of(key)));
+    }
+    template <class K>
+    size_type count_key(const K& key) const;
+    template <class K>
+    size_type erase_key(const K& key) {
+        const size_type h = hash_of(key);
+        size_type res = 0;
+        for (size_type i = find_index(key, h); i != capacity; i = find_index(key, h)) {
+            erase_at(i);
+            ++res;
+        }
+        return res;
+    }
+
+    // 找 key 所在的槽， 找不到返回 capacity
+    // 槽的探测距离小于 d 时， 如果 key 存在， 插入时就会占据这个槽， 所以可以提前结束
+    template <class K>
+    size_type find_index(const K& key, size_type h) const {
+        size_type i = h & mask();
+        for (size_type d = 1; slots[i].dist >= d; ++d) {
+            if (slots[i].dist == d && equals(get_key(slots[i].value), key))
+                return i;
+            i = (i + 1) & mask();
+        }
+        return capacity;
+    }
+
+    // 在空槽 i 上构造元素
+    template <class... Args>
+    void construct_at(size_type i, uint8_t d, Args&&... args) {
+        mystl::construct(&slots[i].value, mystl::forward<Args>(args)...);
+        slots[i].dist = d;
+    }
+
+    // 析构槽 i 的元素， 标记为空槽
+    void destroy_at(size_type i) {
+        mystl::destroy(&slots[i].value);
+        slots[i].dist = 0;
+    }
+
+    template <class... Args>
+    size_type insert_at(size_type h, Args&&... args);
+    size_type place(size_type h, value_type& x);
+    bool try_place(size_type h, value_type& x, size_type& pos);
+    void erase_at(size_type i);
+    void close_hole(size_type i);
+    void rehash(size_type new_cap);
+    void copy_from(const robin_hood_hashtable& ht);
+};
+
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+const uint8_t robin_hood_hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::max_dist;
+
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+template <class K>
+typename robin_hood_hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::size_type
+robin_hood_hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::count_key(const K& key) const {
+    size_type i = hash_of(key) & mask();
+    size_type res = 0;
+    for (size_type d = 1; slots[i].dist >= d; ++d) {
+        if (slots[i].dist == d && equals(get_key(slots[i].value), key))
+            ++res;
+        i = (i + 1) & mask();
+    }
+    return res;
+}
+
+// 用 args 构造新元素， 返回所在的槽
+// 先构造出新元素: args 可能引用表内的元素， 而放置时会移动其他元素或扩容
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+template <class... Args>
+typename robin_hood_hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::size_type
+robin_hood_hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::insert_at(size_type h, Args&&... args) {
+    value_type x(mystl::forward<Args>(args)...);
+    if (num_elements + 1 > max_load(capacity))
+        rehash(capacity * 2);
+    return place(h, x);
+}
+
+// 放置 x， 探测距离超过 255 时扩容， 扩容后 hash 值的更多位参与定位
+// 负载已经很低还放不下， 说明同一 hash 值的元素太多
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+typename robin_hood_hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::size_type
+robin_hood_hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::place(size_type h, value_type& x) {
+    size_type pos;
+    while (!try_place(h, x, pos)) {
+        if (num_elements < capacity / 8)
+            throw std::length_error("robin_hood_hashtable: too many elements with the same hash");
+        rehash(capacity * 2);
+    }
+    ++num_elements;
+    return pos;
+}
+
+// 把 x 放进表里， pos 返回所在的槽， 会导致某个探测距离超过 max_dist 时什么都不做， 返回 false
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+bool robin_hood_hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::try_place(size_type h, value_type& x,
+                                                                                size_type& pos) {
+    // 跳过离理想位置更近(或一样近)的元素， 停在空槽或第一个比 x 更 "富" 的槽
+    size_type i = h & mask();
+    size_type d = 1;
+    while (slots[i].dist >= d) {
+        i = (i + 1) & mask();
+        ++d;
+    }
+    if (d > max_dist)
+        return false;
+    // 找到 i 之后的第一个空槽， [i, empty) 的元素整体后移一格， 探测距离各加 1
+    size_type empty = i;
+    while (slots[empty].dist != 0) {
+        if (slots[empty].dist == max_dist)
+            return false;
+        empty = (empty + 1) & mask();
+    }
+    // 移动抛出异常时， 空出来的槽 j 后面是已经后移的元素， 用 backward shift 移回原位
+    size_type j = empty;
+    try {
+        while (j != i) {
+            const size_type prev = (j - 1) & mask();
+            construct_at(j, static_cast<uint8_t>(slots[prev].dist + 1), mystl::move(slots[prev].value));
+            destroy_at(prev);
+            j = prev;
+        }
+        construct_at(i, static_cast<uint8_t>(d), mystl::move(x));
+    } catch (...) {
+        close_hole(j);
+        throw;
+    }
+    pos = i;
+    return true;
+}
+
+// backward shift: 后面探测距离大于 1 的元素依次前移一格， 直到空槽或已在理想位置的元素
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+void robin_hood_hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::erase_at(size_type i) {
+    destroy_at(i);
+    --num_elements;
+    close_hole(i);
+}
+
+// 空槽 i 后面探测距离大于 1 的元素依次前移一格， 不抛出异常
+// 某个元素移动时抛出异常， 空槽就留在原处， 后面这一段的元素都可能要经过它， 只能全部析构
+// 探测距离为 0 或 1 的槽之后的元素不会经过 i， 不受影响
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+void robin_hood_hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::close_hole(size_type i) {
+    size_type next = (i + 1) & mask();
+    while (slots[next].dist > 1) {
+        try {
+            construct_at(i, static_cast<uint8_t>(slots[next].dist - 1), mystl::move(slots[next].value));
+        } catch (...) {
+            for (; slots[next].dist > 1; next = (next + 1) & mask()) {
+                destroy_at(next);
+                --num_elements;
+            }
+            return;
+        }
+        destroy_at(next);
+        i = next;
+        next = (next + 1) & mask();
+    }
+}
+
+// 把所有元素放进新数组(移动不会抛出异常时移动， 否则复制)， 再和新数组交换
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+void robin_hood_hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::rehash(size_type new_cap) {
+    const __resize_timer timer(resize_callback, capacity);
+    robin_hood_hashtable tmp(max_load(new_cap), hash, equals);
+    tmp.resize_callback = resize_callback;
+    for (size_type i = 0; i < capacity; ++i) {
+        if (slots[i].dist != 0) {
+            value_type x(std::move_if_noexcept(slots[i].value));
+            tmp.place(hash_of(get_key(x)), x);
+        }
+    }
+    swap(tmp);
+    timer.done(capacity);
+}
+
+// 元素的探测长度就是槽里记录的距离
+// 查找失败从每个槽出发的概率相同， 走到距离小于已走步数的槽为止， 这个槽也要访问
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+hashtable_stats robin_hood_hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::stats() const {
+    hashtable_stats res;
+    res.buckets = capacity;
+    res.elements = num_elements;
+    size_type successful = 0;
+    size_type unsuccessful = 0;
+    for (size_type i = 0; i < capacity; ++i) {
+        if (slots[i].dist == 0) {
+            ++res.empty_buckets;
+        } else {
+            res.record(slots[i].dist);
+            successful += slots[i].dist;
+        }
+        size_type j = i;
+        size_type d = 1;
+        while (slots[j].dist >= d) {
+            j = (j + 1) & mask();
+            ++d;
+        }
+        unsuccessful += d;
+    }
+    res.finish(successful, static_cast<double>(unsuccessful) / capacity);
+    return res;
+}
+
+// 槽的布局原样复制
+template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey>
+void robin_hood_hashtable<Value, Key, HashFcn, ExtractKey, EqualKey>::copy_from(const robin_hood_hashtable& ht) {
+    initialize_slots(ht.capacity);
+    try {
+        for (size_type i = 0; i < capacity; ++i) {
+            if (ht.slots[i].dist != 0) {
+                construct_at(i, ht.slots[i].dist, ht.slots[i].value);
+                ++num_elements;
+            }
+        }
+    } catch (...) {
+        destroy_slots();
+        throw;
+    }
+}
+
+}
+
+#endif //FJXTINYSTL_ROBIN_HOOD_HASHTABLE_H
@@ -0,0 +1,282 @@
+#ifndef FJXTINYSTL_SLIST_H
+#define FJXTINYSTL_SLIST_H
+
+//
+// Created by fengjiaxin on 2023/4/23.
+// 单向链表， 参考 SGI 的 stl_slist.h
+// 每个节点只有 next 指针， 节点从内存池 alloc 中分配
+// 只能在某个位置之后插入/删除: insert_after, erase_after, splice_after, push_front 都是 O(1)
+// 元素个数单独记录， size() 为 O(1)
+//
+
+#include <stddef.h>
+#include "iterator.h"
+#include "alloc.h"
+#include "construct.h"
+#include "util.h"
+
+namespace mystl
+{
+
+struct __slist_node_base {
+    __slist_node_base* next;
+};
+
+template <class T>
+struct __slist_node : public __slist_node_base {
+    T data;
+};
+
+// 把 new_node 接在 prev_node 之后
+inline __slist_node_base* __slist_make_link(__slist_node_base* prev_node, __slist_node_base* new_node) {
+    new_node->next = prev_node->next;
+    prev_node->next = new_node;
+    return new_node;
+}
+
+// 从 head 开始找 node 的前一个节点
+inline __slist_node_base* __slist_previous(__slist_node_base* head, const __slist_node_base* node) {
+    while (head && head->next != node)
+        head = head->next;
+    return head;
+}
+
+// 把 (before_first, before_last] 移到 pos 之后
+inline void __slist_splice_after(__slist_node_base* pos, __slist_node_base* before_first,
+                                 __slist_node_base* before_last) {
+    if (pos != before_first && pos != before_last) {
+        __slist_node_base* first = before_first->next;
+        __slist_node_base* after = pos->next;
+        before_first->next = before_last->next;
+        pos->next = first;
+        before_last->next = after;
+    }
+}
+
+// 逆序， 返回新的第一个节点
+inline __slist_node_base* __slist_reverse(__slist_node_base* node) {
+    __slist_node_base* result = node;
+    node = node->next;
+    result->next = nullptr;
+    while (node) {
+        __slist_node_base* next = node->next;
+        node->next = result;
+        result = node;
+        node = next;
+    }
+    return result;
+}
+
+// 迭代器类
+template <class T>
+struct __slist_iterator : public mystl::iterator<mystl::forward_iterator_tag, T> {
+    typedef __slist_iterator<T>      self;
+
+    typedef T                        value_type;
+    typedef T*                       pointer;
+    typedef T&                       reference;
+    typedef __slist_node<T>*         link_type;
+    typedef __slist_node_base*       base_ptr;
+
+    base_ptr node; // end() 为 nullptr
+
+    __slist_iterator() : node(nullptr) {}
+    __slist_iterator(base_ptr x) : node(x) {}
+
+    bool operator==(const self& x) const { return node == x.node; }
+    bool operator!=(const self& x) const { return node != x.node; }
+
+    reference operator*() const { return static_cast<link_type>(node)->data; }
+    pointer operator->() const { return &(operator*()); }
+
+    self& operator++() {
+        node = node->next;
+        return *this;
+    }
+    self operator++(int) {
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+};
+
+// 模板类: slist
+// 模板参数 T 代表数据类型
+template <class T>
+class slist
+{
+public:
+    typedef simple_alloc<__slist_node<T>, alloc>     node_allocator;
+
+    typedef T                                        value_type;
+    typedef T*                                       pointer;
+    typedef const T*                                 const_pointer;
+    typedef T&                                       reference;
+    typedef const T&                                 const_reference;
+    typedef size_t                                   size_type;
+    typedef ptrdiff_t                                difference_type;
+
+    typedef __slist_iterator<T>                      iterator;
+
+private:
+    typedef __slist_node<T>*                         link_type;
+    typedef __slist_node_base*                       base_ptr;
+
+    __slist_node_base head_; // 哨兵， head_.next 是第一个节点， 空链表不分配内存
+    size_type count_; // 元素个数
+
+public:
+    // 构造， 析构
+    slist() : count_(0) {
+        head_.next = nullptr;
+    }
+
+    slist(size_type n, const T& value) : slist() {
+        try {
+            insert_after(before_begin(), n, value);
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    slist(const slist&) = delete;
+    slist& operator=(const slist&) = delete;
+
+    ~slist() {
+        clear();
+    }
+
+public:
+    // 迭代器相关操作
+    iterator before_begin() noexcept { return iterator(&head_); }
+    iterator begin() noexcept { return iterator(head_.next); }
+    iterator end() noexcept { return iterator(nullptr); }
+
+    // pos 的前一个位置， O(n)
+    iterator previous(iterator pos) { return iterator(__slist_previous(&head_, pos.node)); }
+
+    // 容器相关操作
+    bool empty() const noexcept { return head_.next == nullptr; }
+    size_type size() const noexcept { return count_; }
+
+    // 访问元素相关操作
+    reference front() { return static_cast<link_type>(head_.next)->data; }
+
+public:
+    // 在 pos 之后构造元素， 返回指向新元素的迭代器
+    template <class... Args>
+    iterator emplace_after(iterator pos, Args&&... args) {
+        link_type p = create_node(mystl::forward<Args>(args)...);
+        __slist_make_link(pos.node, p);
+        ++count_;
+        return iterator(p);
+    }
+
+    iterator insert_after(iterator pos, const value_type& x) { return emplace_after(pos, x); }
+    iterator insert_after(iterator pos, value_type&& x) { return emplace_after(pos, mystl::move(x)); }
+
+    void insert_after(iterator pos, size_type n, const value_type& x) {
+        for (; n > 0; --n)
+            pos = insert_after(pos, x);
+    }
+
+    template <class... Args>
+    void emplace_front(Args&&... args) { emplace_after(before_begin(), mystl::forward<Args>(args)...); }
+    void push_front(const value_type& x) { emplace_front(x); }
+    void push_front(value_type&& x) { emplace_front(mystl::move(x)); }
+    void pop_front() { erase_after(before_begin()); }
+
+    // 删除 pos 之后的元素， 返回被删元素的下一个位置
+    iterator erase_after(iterator pos) {
+        base_ptr next = pos.node->next;
+        pos.node->next = next->next;
+        destroy_node(static_cast<link_type>(next));
+        --count_;
+        return iterator(pos.node->next);
+    }
+
+    // 删除 (before_first, last) 之间的元素
+    iterator erase_after(iterator before_first, iterator last) {
+        base_ptr cur = before_first.node->next;
+        while (cur != last.node) {
+            base_ptr tmp = cur;
+            cur = cur->next;
+            destroy_node(static_cast<link_type>(tmp));
+            --count_;
+        }
+        before_first.node->next = last.node;
+        return last;
+    }
+
+    void clear() {
+        erase_after(before_begin(), end());
+    }
+
+    // 把 x 的所有元素接到 pos 之后， x 变为空
+    void splice_after(iterator pos, slist& x) {
+        if (&x == this || x.empty())
+            return;
+        __slist_splice_after(pos.node, &x.head_, __slist_previous(&x.head_, nullptr));
+        count_ += x.count_;
+        x.count_ = 0;
+    }
+
+    // 把 prev 之后的那个元素接到 pos 之后， prev 可以来自同一个 slist
+    void splice_after(iterator pos, slist& x, iterator prev) {
+        if (pos == prev || pos.node == prev.node->next)
+            return;
+        __slist_splice_after(pos.node, prev.node, prev.node->next);
+        ++count_;
+        --x.count_;
+    }
+
+    // 把 (before_first, before_last] 接到 pos 之后， pos 不能位于这个区间内
+    // 来自另一个 slist 时需要数一遍区间长度
+    void splice_after(iterator pos, slist& x, iterator before_first, iterator before_last) {
+        if (before_first == before_last)
+            return;
+        if (&x != this) {
+            size_type n = 0;
+            for (base_ptr p = before_first.node; p != before_last.node; p = p->next)
+                ++n;
+            count_ += n;
+            x.count_ -= n;
+        }
+        __slist_splice_after(pos.node, before_first.node, before_last.node);
+    }
+
+    void reverse() {
+        if (head_.next)
+            head_.next = __slist_reverse(head_.next);
+    }
+
+    void swap(slist& rhs) {
+        mystl::swap(head_.next, rhs.head_.next);
+        mystl::swap(count_, rhs.count_);
+    }
+
+private:
+    // 从内存池取一个节点并构造元素
+    template <class... Args>
+    link_type create_node(Args&&... args) {
+        link_type p = node_allocator::allocate();
+        try {
+            mystl::construct(&p->data, mystl::forward<Args>(args)...);
+            p->next = nullptr;
+        } catch (...) {
+            node_allocator::deallocate(p);
+            throw;
+        }
+        return p;
+    }
+
+    void destroy_node(link_type p) {
+        mystl::destroy(&p->data);
+        node_allocator::deallocate(p);
+    }
+};
+
+}
+
+#endif //FJXTINYSTL_SLIST_H
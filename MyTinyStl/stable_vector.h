@@ -0,0 +1,218 @@
+#ifndef FJXTINYSTL_STABLE_VECTOR_H
+#define FJXTINYSTL_STABLE_VECTOR_H
+
+//
+// Created by fengjiaxin on 2023/4/21.
+// stable_vector, 分段的vector, 第k个块的大小是第一个块的 2^k 倍
+// 扩容时只新增一个块， 已有元素从不搬移， 元素的指针/引用在容器生命周期内一直有效
+// 下标 i 所在的块和块内偏移通过一次 bit-scan 算出， O(1)
+//
+
+#include "iterator.h"
+#include "allocator.h"
+#include "construct.h"
+#include "util.h"
+
+namespace mystl
+{
+
+// 第一个块的大小为 2^STABLE_VECTOR_FIRST_CHUNK_SHIFT 个元素
+#ifndef STABLE_VECTOR_FIRST_CHUNK_SHIFT
+#define STABLE_VECTOR_FIRST_CHUNK_SHIFT 4
+#endif
+
+// 最高位 1 的位置， n 必须 > 0
+inline size_t __log2_floor(size_t n) {
+#if defined(__GNUC__) || defined(__clang__)
+    return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(static_cast<unsigned long long>(n));
+#else
+    size_t res = 0;
+    while (n >>= 1)
+        ++res;
+    return res;
+#endif
+}
+
+// 下标 -> (块号， 块内偏移)
+// 前 k 个块共有 B * (2^k - 1) 个元素， 所以 i + B 的最高位决定了块号
+template <size_t Shift>
+struct __stable_vector_index
+{
+    static const size_t first_chunk_size = static_cast<size_t>(1) << Shift;
+
+    static size_t chunk(size_t i) { return mystl::__log2_floor(i + first_chunk_size) - Shift; }
+    static size_t offset(size_t i) {
+        const size_t j = i + first_chunk_size;
+        return j - (static_cast<size_t>(1) << mystl::__log2_floor(j));
+    }
+    static size_t chunk_size(size_t k) { return first_chunk_size << k; }
+};
+
+// stable_vector 的迭代器， 记录块表和下标
+template <class T, class Ref, class Ptr>
+struct __stable_vector_iterator : public iterator<mystl::random_access_iterator_tag, T>
+{
+    typedef __stable_vector_iterator<T, T&, T*>              iterator;
+    typedef __stable_vector_iterator<T, const T&, const T*>  const_iterator;
+    typedef __stable_vector_iterator                         self;
+    typedef __stable_vector_index<STABLE_VECTOR_FIRST_CHUNK_SHIFT> index;
+
+    typedef T           value_type;
+    typedef Ptr         pointer;
+    typedef Ref         reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+    typedef T* const*   chunk_pointer;
+
+    chunk_pointer chunks; // 指向容器的块表
+    size_type     pos;    // 当前元素的下标
+
+    __stable_vector_iterator() noexcept : chunks(nullptr), pos(0) {}
+    __stable_vector_iterator(chunk_pointer c, size_type n) : chunks(c), pos(n) {}
+    __stable_vector_iterator(const iterator& rhs) : chunks(rhs.chunks), pos(rhs.pos) {}
+    self& operator=(const self&) = default;
+
+    reference operator*() const { return chunks[index::chunk(pos)][index::offset(pos)]; }
+    pointer   operator->() const { return &(operator*()); }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    self& operator++() { ++pos; return *this; }
+    self operator++(int) {
+        self tmp = *this;
+        ++pos;
+        return tmp;
+    }
+    self& operator--() { --pos; return *this; }
+    self operator--(int) {
+        self tmp = *this;
+        --pos;
+        return tmp;
+    }
+
+    self& operator+=(difference_type n) { pos += n; return *this; }
+    self& operator-=(difference_type n) { pos -= n; return *this; }
+    self operator+(difference_type n) const { return self(chunks, pos + n); }
+    self operator-(difference_type n) const { return self(chunks, pos - n); }
+    difference_type operator-(const self& x) const {
+        return static_cast<difference_type>(pos) - static_cast<difference_type>(x.pos);
+    }
+
+    bool operator==(const self& rhs) const { return pos == rhs.pos; }
+    bool operator!=(const self& rhs) const { return pos != rhs.pos; }
+    bool operator< (const self& rhs) const { return pos < rhs.pos; }
+    bool operator> (const self& rhs) const { return rhs < *this; }
+    bool operator<=(const self& rhs) const { return !(rhs < *this); }
+    bool operator>=(const self& rhs) const { return !(*this < rhs); }
+};
+
+template <class T>
+class stable_vector
+{
+public:
+    typedef mystl::allocator<T>                      allocator_type;
+    typedef mystl::allocator<T>                      data_allocator;
+
+    typedef typename allocator_type::value_type      value_type;
+    typedef typename allocator_type::pointer         pointer;
+    typedef typename allocator_type::const_pointer   const_pointer;
+    typedef typename allocator_type::reference       reference;
+    typedef typename allocator_type::const_reference const_reference;
+    typedef typename allocator_type::size_type       size_type;
+    typedef typename allocator_type::difference_type difference_type;
+
+    typedef __stable_vector_iterator<T, T&, T*>              iterator;
+    typedef __stable_vector_iterator<T, const T&, const T*>  const_iterator;
+
+private:
+    typedef __stable_vector_index<STABLE_VECTOR_FIRST_CHUNK_SHIFT> index;
+
+    // 块的个数上限， 所有块加起来覆盖整个 size_type 的范围
+    static const size_type max_chunks = sizeof(size_type) * 8 - STABLE_VECTOR_FIRST_CHUNK_SHIFT;
+
+    pointer   chunks[max_chunks]; // 块表， 大小固定， 自身也从不重新分配
+    size_type num_chunks;         // 已经分配的块数
+    size_type count;              // 元素个数
+
+public:
+    // 构造， 析构
+    stable_vector() : num_chunks(0), count(0) {
+        for (size_type k = 0; k < max_chunks; ++k)
+            chunks[k] = nullptr;
+    }
+
+    stable_vector(size_type n, const T& x) : stable_vector() {
+        reserve(n);
+        for (; n > 0; --n)
+            push_back(x);
+    }
+
+    stable_vector(const stable_vector&) = delete;
+    stable_vector& operator=(const stable_vector&) = delete;
+
+    ~stable_vector() {
+        clear();
+        for (size_type k = 0; k < num_chunks; ++k)
+            data_allocator::deallocate(chunks[k], index::chunk_size(k));
+    }
+
+public:
+    // 迭代器相关操作
+    iterator begin() { return iterator(chunks, 0); }
+    iterator end() { return iterator(chunks, count); }
+    const_iterator begin() const { return const_iterator(chunks, 0); }
+    const_iterator end() const { return const_iterator(chunks, count); }
+
+    // 容量相关操作
+    size_type size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_type capacity() const { return index::first_chunk_size * ((static_cast<size_type>(1) << num_chunks) - 1); }
+    // 预先分配块， 之后的 push_back 不再分配内存
+    void reserve(size_type n) {
+        while (capacity() < n)
+            add_chunk();
+    }
+
+    // 访问元素相关操作
+    reference operator[](size_type n) { return chunks[index::chunk(n)][index::offset(n)]; }
+    const_reference operator[](size_type n) const { return chunks[index::chunk(n)][index::offset(n)]; }
+    reference front() { return (*this)[0]; }
+    const_reference front() const { return (*this)[0]; }
+    reference back() { return (*this)[count - 1]; }
+    const_reference back() const { return (*this)[count - 1]; }
+
+public:
+    // 插入删除操作， 只在尾部进行
+    void push_back(const T& x) { emplace_back(x); }
+    void push_back(T&& x) { emplace_back(mystl::move(x)); }
+
+    template <class... Args>
+    reference emplace_back(Args&&... args) {
+        if (count == capacity())
+            add_chunk();
+        pointer p = chunks[index::chunk(count)] + index::offset(count);
+        mystl::construct(p, mystl::forward<Args>(args)...);
+        ++count;
+        return *p;
+    }
+
+    void pop_back() {
+        --count;
+        mystl::destroy(&(*this)[count]);
+    }
+
+    // 只析构元素， 已分配的块保留给以后使用
+    void clear() {
+        while (count > 0)
+            pop_back();
+    }
+
+private:
+    void add_chunk() {
+        chunks[num_chunks] = data_allocator::allocate(index::chunk_size(num_chunks));
+        ++num_chunks;
+    }
+};
+
+}
+
+#endif //FJXTINYSTL_STABLE_VECTOR_H
@@ -21,7 +21,7 @@ public:
 private:
     Sequence c;
 public:
-    bool empty() { return c.emtpy(); }
+    bool empty() { return c.empty(); }
     size_type size() { return c.size(); }
     reference top() { return c.back(); }
     void push(const value_type& x) { c.push_back(x); }
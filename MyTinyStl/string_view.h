@@ -0,0 +1,91 @@
+#ifndef FJXTINYSTL_STRING_VIEW_H
+#define FJXTINYSTL_STRING_VIEW_H
+
+//
+// Created by fengjiaxin on 2023/4/24.
+// 只读字符串视图: 指针 + 长度， 不拥有内存， 不要求以 '\0' 结尾
+// 可以由 const char*， (指针， 长度)， std::string 隐式构造
+// hash<string_view> 和 equal_to<string_view> 带有 is_transparent，
+// 用作 hash_map<std::string, V> 的模板参数时， find/count/erase 可以直接传 string_view 或 const char*， 不构造临时 std::string
+//
+
+#include <stddef.h>
+#include <string.h>
+#include <string>
+#include "hash_fun.h"
+#include "functional.h"
+
+namespace mystl
+{
+
+class string_view
+{
+public:
+    typedef char             value_type;
+    typedef const char*      pointer;
+    typedef const char*      const_pointer;
+    typedef const char&      reference;
+    typedef const char&      const_reference;
+    typedef const char*      iterator;
+    typedef const char*      const_iterator;
+    typedef size_t           size_type;
+    typedef ptrdiff_t        difference_type;
+
+private:
+    const char* ptr;
+    size_type len;
+
+public:
+    // 构造
+    string_view() noexcept : ptr(nullptr), len(0) {}
+    string_view(const char* s) : ptr(s), len(strlen(s)) {}
+    string_view(const char* s, size_type n) noexcept : ptr(s), len(n) {}
+    string_view(const std::string& s) noexcept : ptr(s.data()), len(s.size()) {}
+
+    // 迭代器相关操作
+    const_iterator begin() const noexcept { return ptr; }
+    const_iterator end() const noexcept { return ptr + len; }
+
+    // 容量相关操作
+    size_type size() const noexcept { return len; }
+    size_type length() const noexcept { return len; }
+    bool empty() const noexcept { return len == 0; }
+
+    // 访问元素相关操作
+    const_reference operator[](size_type n) const { return ptr[n]; }
+    const_pointer data() const noexcept { return ptr; }
+
+    std::string to_string() const { return std::string(ptr, len); }
+
+    int compare(string_view rhs) const noexcept {
+        const size_type n = len < rhs.len ? len : rhs.len;
+        const int res = n == 0 ? 0 : memcmp(ptr, rhs.ptr, n);
+        if (res != 0)
+            return res;
+        return len < rhs.len ? -1 : (len > rhs.len ? 1 : 0);
+    }
+};
+
+inline bool operator==(string_view lhs, string_view rhs) noexcept {
+    return lhs.size() == rhs.size() && (lhs.size() == 0 || memcmp(lhs.data(), rhs.data(), lhs.size()) == 0);
+}
+inline bool operator!=(string_view lhs, string_view rhs) noexcept { return !(lhs == rhs); }
+inline bool operator<(string_view lhs, string_view rhs) noexcept { return lhs.compare(rhs) < 0; }
+
+// 和 hash<std::string>， hash<const char*> 结果相同
+template <>
+struct hash<string_view> {
+    typedef void is_transparent;
+    size_t operator()(string_view s) const { return __stl_hash_string(s.data(), s.size()); }
+};
+
+// 按内容比较， const char* 也不会退化成指针比较
+template <>
+struct equal_to<string_view> : public binary_function<string_view, string_view, bool> {
+    typedef void is_transparent;
+    bool operator()(string_view x, string_view y) const { return x == y; }
+};
+
+}
+
+#endif //FJXTINYSTL_STRING_VIEW_H
@@ -41,6 +41,7 @@ namespace mystl {
                 mystl::construct(&*cur, value);
         } catch (...) {
             mystl::destroy(first, cur);
+            throw;
         }
         return cur;
     }
@@ -73,7 +74,9 @@ namespace mystl {
                 mystl::construct(&*cur, *first);
         } catch (...) {
             mystl::destroy(result, cur);
+            throw;
         }
+        return cur;
     }
 
     template<class InputIter, class ForwardIter>
@@ -122,14 +125,16 @@ namespace mystl {
                 mystl::construct(&*cur, mystl::move(*first));
         } catch (...) {
             mystl::destroy(result, cur);
+            throw;
         }
+        return cur;
     }
 
     template<class InputIter, class ForwardIter>
     inline ForwardIter
     __uninitialized_move(InputIter first, InputIter last, ForwardIter res) {
         typedef typename mystl::iterator_traits<ForwardIter>::value_type value_type;
-        return mystl::__uninitialized_copy_aux(first, last, res, std::is_trivially_move_assignable<value_type>{});
+        return mystl::__uninitialized_move_aux(first, last, res, std::is_trivially_move_assignable<value_type>{});
     }
 
     template<class InputIter, class ForwardIter>
@@ -170,6 +175,7 @@ namespace mystl {
                 mystl::construct(&*cur, x);
         } catch (...) {
             mystl::destroy(first, cur);
+            throw;
         }
     }
 
@@ -177,7 +183,7 @@ namespace mystl {
     template<class ForwardIter, class T>
     void uninitialized_fill(ForwardIter first, ForwardIter last, const T &x) {
         typedef typename mystl::iterator_traits<ForwardIter>::value_type value_type;
-        __uninitialized_fill_n_aux(first, last, std::is_trivially_copy_assignable<value_type>{});
+        mystl::__uninitialized_fill_aux(first, last, x, std::is_trivially_copy_assignable<value_type>{});
     }
 }
 
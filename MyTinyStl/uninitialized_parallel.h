@@ -0,0 +1,133 @@
+#ifndef FJXTINYSTL_UNINITIALIZED_PARALLEL_H
+#define FJXTINYSTL_UNINITIALIZED_PARALLEL_H
+
+//
+// Created by fengjiaxin on 2023/4/21.
+// uninitialized_fill_n / uninitialized_copy 的并行版本
+// 把区间切成若干段， 每段交给一个线程构造， 适用于很大的缓冲区:
+// 1. 缩短构造的墙钟时间
+// 2. 每个线程首次触碰自己那段内存， 缺页中断分散到多个核(多路机器上也分散到多个 NUMA 节点)
+// 区间太小时退化为单线程版本
+//
+
+#include <thread>
+#include <exception>
+#include <memory>
+#include "iterator.h"
+#include "construct.h"
+#include "uninitialized.h"
+
+namespace mystl
+{
+
+// 每个线程至少负责的字节数， 总量不足两段时不开线程
+#ifndef MYSTL_PARALLEL_SLICE_BYTES
+#define MYSTL_PARALLEL_SLICE_BYTES (1 << 22)
+#endif
+
+// 并行初始化的开关， 作为容器构造函数/insert 的额外参数传入
+struct parallel_init_t {};
+constexpr parallel_init_t parallel_init{};
+
+// 计算切成几段
+inline size_t __parallel_parts(size_t n, size_t elem_size) {
+    const size_t by_size = n * elem_size / MYSTL_PARALLEL_SLICE_BYTES;
+    size_t hw = std::thread::hardware_concurrency();
+    if (hw == 0) hw = 1;
+    const size_t parts = by_size < hw ? by_size : hw;
+    return parts > 1 ? parts : 1;
+}
+
+// 把 [0, n) 切成 parts 段， 第 i 段调用 fn(begin, end)， 当前线程负责最后一段
+// 有段抛出异常时， 对成功的段调用 undo(begin, end)， 再把第一个异常重新抛出
+template <class Func, class Undo>
+void __parallel_for(size_t n, size_t parts, Func fn, Undo undo) {
+    const size_t step = n / parts;
+    const size_t rem = n % parts;
+    std::unique_ptr<size_t[]> bounds(new size_t[parts + 1]);
+    bounds[0] = 0;
+    for (size_t i = 0; i < parts; ++i)
+        bounds[i + 1] = bounds[i] + step + (i < rem ? 1 : 0);
+
+    std::unique_ptr<std::exception_ptr[]> errors(new std::exception_ptr[parts]);
+    std::unique_ptr<std::thread[]> threads(new std::thread[parts - 1]);
+    for (size_t i = 0; i + 1 < parts; ++i) {
+        const size_t b = bounds[i], e = bounds[i + 1];
+        std::exception_ptr* err = &errors[i];
+        try {
+            threads[i] = std::thread([=]() {
+                try {
+                    fn(b, e);
+                } catch (...) {
+                    *err = std::current_exception();
+                }
+            });
+        } catch (...) {
+            // 开线程失败， 这一段在当前线程完成
+            try {
+                fn(b, e);
+            } catch (...) {
+                *err = std::current_exception();
+            }
+        }
+    }
+    try {
+        fn(bounds[parts - 1], bounds[parts]);
+    } catch (...) {
+        errors[parts - 1] = std::current_exception();
+    }
+    for (size_t i = 0; i + 1 < parts; ++i) {
+        if (threads[i].joinable())
+            threads[i].join();
+    }
+
+    std::exception_ptr first_error;
+    for (size_t i = 0; i < parts; ++i) {
+        if (errors[i] && !first_error)
+            first_error = errors[i];
+    }
+    if (first_error) {
+        for (size_t i = 0; i < parts; ++i) {
+            if (!errors[i])
+                undo(bounds[i], bounds[i + 1]);
+        }
+        std::rethrow_exception(first_error);
+    }
+}
+
+/*****************************************************************************************/
+// parallel_uninitialized_fill_n
+// 同 uninitialized_fill_n, 要求随机访问迭代器
+/*****************************************************************************************/
+template <class RandomAccessIter, class Size, class T>
+RandomAccessIter parallel_uninitialized_fill_n(RandomAccessIter first, Size n, const T& x) {
+    typedef typename mystl::iterator_traits<RandomAccessIter>::value_type value_type;
+    const size_t parts = mystl::__parallel_parts(static_cast<size_t>(n), sizeof(value_type));
+    if (parts == 1)
+        return mystl::uninitialized_fill_n(first, n, x);
+    mystl::__parallel_for(static_cast<size_t>(n), parts,
+        [first, &x](size_t b, size_t e) { mystl::uninitialized_fill_n(first + b, e - b, x); },
+        [first](size_t b, size_t e) { mystl::destroy(first + b, first + e); });
+    return first + n;
+}
+
+/*****************************************************************************************/
+// parallel_uninitialized_copy
+// 同 uninitialized_copy, 要求随机访问迭代器
+/*****************************************************************************************/
+template <class RandomAccessIter, class RandomAccessIter2>
+RandomAccessIter2 parallel_uninitialized_copy(RandomAccessIter first, RandomAccessIter last, RandomAccessIter2 res) {
+    typedef typename mystl::iterator_traits<RandomAccessIter2>::value_type value_type;
+    const size_t n = static_cast<size_t>(last - first);
+    const size_t parts = mystl::__parallel_parts(n, sizeof(value_type));
+    if (parts == 1)
+        return mystl::uninitialized_copy(first, last, res);
+    mystl::__parallel_for(n, parts,
+        [first, res](size_t b, size_t e) { mystl::uninitialized_copy(first + b, first + e, res + b); },
+        [res](size_t b, size_t e) { mystl::destroy(res + b, res + e); });
+    return res + n;
+}
+
+}
+
+#endif //FJXTINYSTL_UNINITIALIZED_PARALLEL_H
@@ -0,0 +1,337 @@
+#ifndef FJXTINYSTL_UNROLLED_LIST_H
+#define FJXTINYSTL_UNROLLED_LIST_H
+
+//
+// Created by fengjiaxin on 2023/4/23.
+// 展开链表， 每个节点存放最多 K 个元素， 元素连续存放在节点内的数组里
+// 相比 list 每个元素分摊的指针开销是 1/K， 遍历时大部分是顺序访存
+// 迭代器是 (节点， 节点内下标):
+//   insert 只使同一节点(节点满时分裂出的新节点)内的迭代器失效
+//   erase 只使同一节点(以及被合并进来的下一节点)内的迭代器失效
+//
+
+#include <stddef.h>
+#include <type_traits>
+#include "iterator.h"
+#include "allocator.h"
+#include "construct.h"
+#include "uninitialized.h"
+#include "algobase.h"
+#include "util.h"
+
+namespace mystl
+{
+
+// 默认每个节点约 256 字节的元素， 至少 4 个
+constexpr size_t __unrolled_list_default_k(size_t sz) {
+    return sz < 64 ? 256 / sz : 4;
+}
+
+// 节点公共部分， 哨兵只需要这部分
+struct __unrolled_node_base {
+    __unrolled_node_base* prev;
+    __unrolled_node_base* next;
+    size_t count; // 节点内元素个数
+};
+
+template <class T, size_t K>
+struct __unrolled_node : public __unrolled_node_base {
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage[K];
+
+    T* data() { return reinterpret_cast<T*>(storage); }
+};
+
+// 迭代器类
+template <class T, class Ref, class Ptr, size_t K>
+struct __unrolled_list_iterator : public mystl::iterator<mystl::bidirectional_iterator_tag, T> {
+    typedef __unrolled_list_iterator<T, T&, T*, K>              iterator;
+    typedef __unrolled_list_iterator<T, const T&, const T*, K>  const_iterator;
+    typedef __unrolled_list_iterator                            self;
+
+    typedef T                       value_type;
+    typedef Ptr                     pointer;
+    typedef Ref                     reference;
+    typedef __unrolled_node_base*   base_ptr;
+    typedef __unrolled_node<T, K>*  link_type;
+
+    base_ptr node; // 所在节点， end() 时为哨兵
+    size_t   idx;  // 节点内下标
+
+    __unrolled_list_iterator() : node(nullptr), idx(0) {}
+    __unrolled_list_iterator(base_ptr x, size_t i) : node(x), idx(i) {}
+    __unrolled_list_iterator(const iterator& x) : node(x.node), idx(x.idx) {}
+    self& operator=(const self&) = default;
+
+    bool operator==(const self& x) const { return node == x.node && idx == x.idx; }
+    bool operator!=(const self& x) const { return !(*this == x); }
+
+    reference operator*() const { return static_cast<link_type>(node)->data()[idx]; }
+    pointer operator->() const { return &(operator*()); }
+
+    self& operator++() {
+        if (++idx == node->count) {
+            node = node->next;
+            idx = 0;
+        }
+        return *this;
+    }
+    self operator++(int) {
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+    self& operator--() {
+        if (idx == 0) {
+            node = node->prev;
+            idx = node->count - 1;
+        } else {
+            --idx;
+        }
+        return *this;
+    }
+    self operator--(int) {
+        self tmp = *this;
+        --*this;
+        return tmp;
+    }
+};
+
+// 模板类: unrolled_list
+// 模板参数 T 代表数据类型， K 代表每个节点最多存放的元素个数
+template <class T, size_t K = __unrolled_list_default_k(sizeof(T))>
+class unrolled_list
+{
+    static_assert(K >= 2, "unrolled_list node must hold at least 2 elements");
+
+public:
+    typedef mystl::allocator<T>                       allocator_type;
+    typedef mystl::allocator<__unrolled_node<T, K>>   node_allocator;
+
+    typedef typename allocator_type::value_type       value_type;
+    typedef typename allocator_type::pointer          pointer;
+    typedef typename allocator_type::const_pointer    const_pointer;
+    typedef typename allocator_type::reference        reference;
+    typedef typename allocator_type::const_reference  const_reference;
+    typedef typename allocator_type::size_type        size_type;
+    typedef typename allocator_type::difference_type  difference_type;
+
+    typedef __unrolled_list_iterator<T, T&, T*, K>              iterator;
+    typedef __unrolled_list_iterator<T, const T&, const T*, K>  const_iterator;
+
+    static const size_type node_capacity = K;
+
+private:
+    typedef __unrolled_node_base*   base_ptr;
+    typedef __unrolled_node<T, K>*  link_type;
+
+    __unrolled_node_base head_; // 哨兵， 空链表不分配内存
+    size_type count_; // 元素个数
+
+public:
+    // 构造， 析构
+    unrolled_list() : count_(0) {
+        head_.prev = &head_;
+        head_.next = &head_;
+        head_.count = 0;
+    }
+
+    unrolled_list(const unrolled_list&) = delete;
+    unrolled_list& operator=(const unrolled_list&) = delete;
+
+    ~unrolled_list() {
+        clear();
+    }
+
+public:
+    // 迭代器相关操作
+    iterator begin() noexcept { return iterator(head_.next, 0); }
+    iterator end() noexcept { return iterator(&head_, 0); }
+    const_iterator begin() const noexcept { return const_iterator(head_.next, 0); }
+    const_iterator end() const noexcept { return const_iterator(const_cast<base_ptr>(&head_), 0); }
+
+    // 容器相关操作
+    bool empty() const noexcept { return count_ == 0; }
+    size_type size() const noexcept { return count_; }
+
+    // 访问元素相关操作
+    reference front() { return *begin(); }
+    reference back() { return *(--end()); }
+
+public:
+    // 在 position 前构造元素， 返回指向新元素的迭代器
+    template <class... Args>
+    iterator emplace(iterator position, Args&&... args);
+
+    iterator insert(iterator position, const value_type& x) { return emplace(position, x); }
+    iterator insert(iterator position, value_type&& x) { return emplace(position, mystl::move(x)); }
+
+    // 删除 position 处的元素， 返回下一个元素的迭代器
+    iterator erase(iterator position);
+
+    void push_back(const value_type& x) { emplace(end(), x); }
+    void push_back(value_type&& x) { emplace(end(), mystl::move(x)); }
+    void push_front(const value_type& x) { emplace(begin(), x); }
+    void push_front(value_type&& x) { emplace(begin(), mystl::move(x)); }
+    void pop_front() { erase(begin()); }
+    void pop_back() { erase(--end()); }
+
+    void clear() {
+        base_ptr cur = head_.next;
+        while (cur != &head_) {
+            base_ptr tmp = cur;
+            cur = cur->next;
+            link_type p = static_cast<link_type>(tmp);
+            mystl::destroy(p->data(), p->data() + p->count);
+            node_allocator::deallocate(p);
+        }
+        head_.next = &head_;
+        head_.prev = &head_;
+        count_ = 0;
+    }
+
+private:
+    // 在 pos 之后新建一个空节点
+    link_type create_node_after(base_ptr pos) {
+        link_type p = node_allocator::allocate();
+        p->count = 0;
+        p->prev = pos;
+        p->next = pos->next;
+        pos->next->prev = p;
+        pos->next = p;
+        return p;
+    }
+
+    void unlink_node(base_ptr p) {
+        p->prev->next = p->next;
+        p->next->prev = p->prev;
+        node_allocator::deallocate(static_cast<link_type>(p));
+    }
+
+    // 把 from 中下标 >= first 的元素搬到 to 的末尾， 抛出异常时两个节点都保持原样
+    // 和 move_if_noexcept 一样: 移动构造可能抛出异常时改用复制， 失败时源元素没有被移动过
+    // 只能移动且移动构造可能抛出异常的型别没有这个保证
+    static void move_tail(link_type from, size_t first, link_type to) {
+        T* src = from->data();
+        relocate(src + first, src + from->count, to->data() + to->count,
+                 std::integral_constant<bool, std::is_nothrow_move_constructible<T>::value ||
+                                              !std::is_copy_constructible<T>::value>());
+        mystl::destroy(src + first, src + from->count);
+        to->count += from->count - first;
+        from->count = first;
+    }
+
+    static void relocate(T* first, T* last, T* result, std::true_type) {
+        mystl::uninitialized_move(first, last, result);
+    }
+    static void relocate(T* first, T* last, T* result, std::false_type) {
+        mystl::uninitialized_copy(first, last, result);
+    }
+
+    base_ptr make_room(base_ptr node, size_t& idx);
+
+    // 在未满节点的 idx 处构造元素， 后面的元素后移一位
+    template <class... Args>
+    static void emplace_in_node(link_type p, size_t idx, Args&&... args) {
+        T* data = p->data();
+        if (idx == p->count) {
+            mystl::construct(data + idx, mystl::forward<Args>(args)...);
+        } else {
+            // args 可能引用节点内的元素， 先构造出新元素再平移
+            value_type x_copy(mystl::forward<Args>(args)...);
+            mystl::construct(data + p->count, mystl::move(data[p->count - 1]));
+            mystl::move_backward(data + idx, data + p->count - 1, data + p->count);
+            data[idx] = mystl::move(x_copy);
+        }
+        ++p->count;
+    }
+};
+
+template <class T, size_t K>
+const typename unrolled_list<T, K>::size_type unrolled_list<T, K>::node_capacity;
+
+template <class T, size_t K>
+template <class... Args>
+typename unrolled_list<T, K>::iterator
+unrolled_list<T, K>::emplace(iterator position, Args&&... args) {
+    base_ptr node = position.node;
+    size_t idx = position.idx;
+    // 插在节点开头(或末尾)而前一个节点还有空位时， 接在前一个节点的末尾
+    if (idx == 0 && node->prev != &head_ && node->prev->count < K) {
+        node = node->prev;
+        idx = node->count;
+    }
+    if (node != &head_ && node->count < K) {
+        emplace_in_node(static_cast<link_type>(node), idx, mystl::forward<Args>(args)...);
+    } else {
+        // args 可能引用即将被搬走的元素， 先构造出新元素
+        value_type x_copy(mystl::forward<Args>(args)...);
+        node = make_room(node, idx);
+        try {
+            emplace_in_node(static_cast<link_type>(node), idx, mystl::move(x_copy));
+        } catch (...) {
+            if (node->count == 0)
+                unlink_node(node);
+            throw;
+        }
+    }
+    ++count_;
+    return iterator(node, idx);
+}
+
+// node 是哨兵(插在末尾)或已满的节点， 返回有空位的节点并修正 idx
+template <class T, size_t K>
+typename unrolled_list<T, K>::base_ptr
+unrolled_list<T, K>::make_room(base_ptr node, size_t& idx) {
+    if (node == &head_) {
+        // 链表为空， 或者插在末尾且最后一个节点已满
+        idx = 0;
+        return create_node_after(head_.prev);
+    }
+    // 节点已满， 后一半元素搬到新节点
+    link_type q = create_node_after(node);
+    try {
+        move_tail(static_cast<link_type>(node), K / 2, q);
+    } catch (...) {
+        unlink_node(q);
+        throw;
+    }
+    if (idx > K / 2) {
+        idx -= K / 2;
+        return q;
+    }
+    return node;
+}
+
+template <class T, size_t K>
+typename unrolled_list<T, K>::iterator
+unrolled_list<T, K>::erase(iterator position) {
+    link_type p = static_cast<link_type>(position.node);
+    const size_t idx = position.idx;
+    T* data = p->data();
+    mystl::move(data + idx + 1, data + p->count, data + idx);
+    --p->count;
+    mystl::destroy(data + p->count);
+    --count_;
+    if (p->count == 0) {
+        base_ptr next = p->next;
+        unlink_node(p);
+        return iterator(next, 0);
+    }
+    // 和下一个节点加起来不超过半满时合并， 保持节点的填充率
+    base_ptr next = p->next;
+    if (next != &head_ && p->count + next->count <= K / 2) {
+        try {
+            move_tail(static_cast<link_type>(next), 0, p);
+            unlink_node(next);
+        } catch (...) {
+            // 合并只是优化， 失败时两个节点都保持原样
+        }
+    }
+    if (idx < p->count)
+        return iterator(p, idx);
+    return iterator(p->next, 0);
+}
+
+}
+
+#endif //FJXTINYSTL_UNROLLED_LIST_H
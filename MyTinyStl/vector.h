@@ -10,7 +10,9 @@
 #include "allocator.h"
 #include "iterator.h"
 #include "algobase.h"
+#include "algo.h"
 #include "uninitialized.h"
+#include "uninitialized_parallel.h"
 #include <memory>
 
 namespace mystl
@@ -77,19 +79,43 @@ private:
         if (start) data_allocator::deallocate(start, end_of_storage - start);
     }
 
+    // 未初始化空间上的填充/拷贝， std::true_type 表示并行初始化
+    static iterator uninit_fill_n(iterator first, size_type n, const T& x, std::false_type) {
+        return mystl::uninitialized_fill_n(first, n, x);
+    }
+    static iterator uninit_fill_n(iterator first, size_type n, const T& x, std::true_type) {
+        return mystl::parallel_uninitialized_fill_n(first, n, x);
+    }
+    static iterator uninit_copy(iterator first, iterator last, iterator res, std::false_type) {
+        return mystl::uninitialized_copy(first, last, res);
+    }
+    static iterator uninit_copy(iterator first, iterator last, iterator res, std::true_type) {
+        return mystl::parallel_uninitialized_copy(first, last, res);
+    }
+
     // 配置后填充
-    iterator allocate_and_fill(size_type n, const T& x) {
+    template <class Parallel>
+    iterator allocate_and_fill(size_type n, const T& x, Parallel tag) {
         iterator res = data_allocator::allocate(n);
-        mystl::uninitialized_fill_n(res, n, x);
+        try {
+            uninit_fill_n(res, n, x, tag);
+        } catch (...) {
+            data_allocator::deallocate(res, n);
+            throw;
+        }
         return res;
     }
 
-    void fill_initialize(size_type n, const T& x) {
-        start = allocate_and_fill(n, x);
+    template <class Parallel = std::false_type>
+    void fill_initialize(size_type n, const T& x, Parallel tag = Parallel()) {
+        start = allocate_and_fill(n, x, tag);
         finish = start + n;
         end_of_storage = finish;
     }
 
+    template <class Parallel>
+    void fill_insert(iterator pos, size_type n, const T& x, Parallel tag);
+
 public:
     // 迭代器相关操作
     iterator begin() { return start;}
@@ -98,7 +124,7 @@ public:
     // 容量相关操作
     size_type size() const { return static_cast<size_type>(finish - start);}
     size_type capacity() const { return static_cast<size_type>(end_of_storage - start);}
-    bool empty() { return begin() == end() ;}
+    bool empty() const { return start == finish; }
     void reserve(size_type n); // 分配相关内存操作
     // swap
     void swap(vector& rhs) noexcept {
@@ -111,6 +137,7 @@ public:
 
     // 访问元素相关操作
     reference operator[](size_type n) { return *(begin() + n);}
+    const_reference operator[](size_type n) const { return *(start + n); }
     reference front() { return *begin(); }
     reference back() { return *(end() - 1);}
 
@@ -119,6 +146,8 @@ public:
     vector(): start(nullptr), finish(nullptr), end_of_storage(nullptr) {}
     vector(size_type n, const T& x) { fill_initialize(n, x);}
     explicit vector(size_type n) { fill_initialize(n, T());}
+    // 并行初始化， 适用于很大的 n
+    vector(size_type n, const T& x, parallel_init_t) { fill_initialize(n, x, std::true_type()); }
 
     vector(const vector& v) = delete;
     vector(const vector&& v) = delete;
@@ -161,56 +190,84 @@ public:
         return first;
     }
 
+    // 不保持元素顺序的删除， 用最后一个元素覆盖pos后pop_back, O(1)
+    iterator unordered_erase(iterator pos) {
+        if (pos + 1 != end())
+            *pos = mystl::move(*(finish - 1));
+        pop_back();
+        return pos;
+    }
+
+    // 删除所有令 pred 为 true 的元素， 幸存元素一趟搬移完成， 返回删除的个数
+    template <class Predicate>
+    size_type erase_if(Predicate pred) {
+        iterator new_finish = mystl::remove_if(begin(), end(), pred);
+        const size_type n = static_cast<size_type>(finish - new_finish);
+        erase(new_finish, end());
+        return n;
+    }
+
     void clear() { erase(begin(), end());}
 
     void insert(iterator pos, size_type n, const T& x) {
-        if (n == 0) return;
-        if (size_type(end_of_storage - finish) >= n) { // 剩余空间足够
-            T x_copy = x;
-            // 计算插入点之后的现有元素个数
-            const size_type elems_after = finish - pos;
-            iterator old_finish = finish;
-            if (elems_after > n) {
-                // 插入点之后的现有元素个数 > 新增元素个数
-                mystl::uninitialized_copy(finish - n,finish, finish);
-                finish += n;
-                mystl::copy_backward(pos, old_finish -n, old_finish);
-                mystl::fill(pos, pos + n , x_copy);
-            } else {
-                // 插入点之后的现有元素个数 <= 新增元素个数
-                mystl::uninitialized_fill_n(finish, n - elems_after, x_copy);
-                finish += n - elems_after;
-                mystl::uninitialized_copy(pos, old_finish, finish);
-                finish += elems_after;
-                mystl::fill(pos, old_finish, x_copy);
-            }
-        } else { // 剩余空间不够
-            const size_type old_size = size();
-            size_type new_size = old_size;
-            while (new_size <= old_size + n)
-                new_size *= 2;
-            // 配置新空间
-            iterator new_start = data_allocator::allocate(new_size);
-            iterator new_finish = new_start;
-            try {
-                new_finish = mystl::uninitialized_copy(start, pos, new_start);
-                new_finish = mystl::uninitialized_fill_n(new_finish, n, x);
-                new_finish = mystl::uninitialized_copy(pos, finish, new_finish);
-            } catch (...) {
-                mystl::destroy(new_start, new_finish);
-                data_allocator::deallocate(new_start, new_size);
-                throw;
-            }
-            // 销毁原来的空间
-            mystl::destroy(start, finish);
-            deallocate();
-            start = new_start;
-            finish = new_finish;
-            end_of_storage = new_start + new_size;
-        }
+        fill_insert(pos, n, x, std::false_type());
+    }
+
+    // 并行初始化新增元素
+    void insert(iterator pos, size_type n, const T& x, parallel_init_t) {
+        fill_insert(pos, n, x, std::true_type());
     }
 };
 
+template <class T>
+template <class Parallel>
+void vector<T>::fill_insert(iterator pos, size_type n, const T& x, Parallel tag) {
+    if (n == 0) return;
+    if (size_type(end_of_storage - finish) >= n) { // 剩余空间足够
+        T x_copy = x;
+        // 计算插入点之后的现有元素个数
+        const size_type elems_after = finish - pos;
+        iterator old_finish = finish;
+        if (elems_after > n) {
+            // 插入点之后的现有元素个数 > 新增元素个数
+            uninit_copy(finish - n, finish, finish, tag);
+            finish += n;
+            mystl::copy_backward(pos, old_finish -n, old_finish);
+            mystl::fill(pos, pos + n , x_copy);
+        } else {
+            // 插入点之后的现有元素个数 <= 新增元素个数
+            uninit_fill_n(finish, n - elems_after, x_copy, tag);
+            finish += n - elems_after;
+            uninit_copy(pos, old_finish, finish, tag);
+            finish += elems_after;
+            mystl::fill(pos, old_finish, x_copy);
+        }
+    } else { // 剩余空间不够
+        const size_type old_size = size();
+        size_type new_size = old_size != 0 ? old_size : 1;
+        while (new_size <= old_size + n)
+            new_size *= 2;
+        // 配置新空间
+        iterator new_start = data_allocator::allocate(new_size);
+        iterator new_finish = new_start;
+        try {
+            new_finish = uninit_copy(start, pos, new_start, tag);
+            new_finish = uninit_fill_n(new_finish, n, x, tag);
+            new_finish = uninit_copy(pos, finish, new_finish, tag);
+        } catch (...) {
+            mystl::destroy(new_start, new_finish);
+            data_allocator::deallocate(new_start, new_size);
+            throw;
+        }
+        // 销毁原来的空间
+        mystl::destroy(start, finish);
+        deallocate();
+        start = new_start;
+        finish = new_finish;
+        end_of_storage = new_start + new_size;
+    }
+}
+
 template <class T>
 void vector<T>::reserve(size_type n) {
     if (capacity() < n) {
@@ -2,7 +2,7 @@
 // Created by fengjiaxin on 2023/4/20.
 //
 #include <iostream>
-#include "../../FjxTinyStl/MyTinyStl/alloc.h"
+#include "../MyTinyStl/alloc.h"
 #include <cstddef>
 
 using namespace std;
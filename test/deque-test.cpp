@@ -6,8 +6,109 @@
 #include "../MyTinyStl/deque.h"
 #include "../MyTinyStl/algo.h"
 #include <iostream>
+#include <string>
+#include <memory>
+#include <stdexcept>
 using namespace std;
 
+typedef mystl::deque<int, 4> small_deque;
+
+// 0..n-1， 前面 push_front 几个， 让 begin() 落在缓冲区中间
+static void fill_seq(small_deque& d, int n) {
+    d.clear();
+    for (int i = 2; i < n; ++i)
+        d.push_back(i);
+    d.push_front(1);
+    d.push_front(0);
+}
+
+// 第 copy_budget 次复制构造时抛出异常， live 记录存活的对象数
+static int copy_budget = -1;
+static int live = 0;
+struct throwing_copy {
+    int v;
+    explicit throwing_copy(int x) : v(x) { ++live; }
+    throwing_copy(const throwing_copy& rhs) : v(rhs.v) {
+        if (copy_budget == 0)
+            throw std::runtime_error("copy");
+        --copy_budget;
+        ++live;
+    }
+    throwing_copy& operator=(const throwing_copy& rhs) { v = rhs.v; return *this; }
+    ~throwing_copy() { --live; }
+};
+
+// 分段版本的 copy/copy_backward/fill/find 与逐元素循环的结果比较
+// 所有 [a, b) 子区间都试一遍， 包括空区间， 缓冲区中间开始或结束， 跨多个缓冲区
+static bool check_segmented(int n) {
+    small_deque src, dst;
+    fill_seq(src, n);
+    int buf[64];
+    for (int a = 0; a <= n; ++a) {
+        for (int b = a; b <= n; ++b) {
+            // copy: deque -> 指针
+            int* end = mystl::copy(src.begin() + a, src.begin() + b, buf);
+            if (end != buf + (b - a))
+                return false;
+            for (int i = a; i < b; ++i)
+                if (buf[i - a] != i)
+                    return false;
+
+            // copy: 指针 -> deque， 写到 dst 的 [a, b)
+            fill_seq(dst, n);
+            for (int i = 0; i < b - a; ++i)
+                buf[i] = 100 + i;
+            small_deque::iterator out = mystl::copy(buf, buf + (b - a), dst.begin() + a);
+            if (out != dst.begin() + b)
+                return false;
+            for (int i = 0; i < n; ++i)
+                if (dst[i] != (i >= a && i < b ? 100 + i - a : i))
+                    return false;
+
+            // copy: deque -> deque， 目标错开一格， 两边的缓冲区边界不对齐
+            fill_seq(dst, n + 1);
+            out = mystl::copy(src.begin() + a, src.begin() + b, dst.begin() + 1 + a);
+            if (out != dst.begin() + 1 + b)
+                return false;
+            for (int i = 0; i <= n; ++i)
+                if (dst[i] != (i >= a + 1 && i < b + 1 ? i - 1 : i))
+                    return false;
+
+            // copy_backward: 同一个 deque 内整体后移 k 格， 区间重叠
+            for (int k = 0; a + k <= n && b + k <= n; k += 3) {
+                fill_seq(dst, n);
+                int ref[64];
+                for (int i = 0; i < n; ++i)
+                    ref[i] = i;
+                for (int i = b - 1; i >= a; --i)
+                    ref[i + k] = ref[i];
+                out = mystl::copy_backward(dst.begin() + a, dst.begin() + b, dst.begin() + b + k);
+                if (out != dst.begin() + a + k)
+                    return false;
+                for (int i = 0; i < n; ++i)
+                    if (dst[i] != ref[i])
+                        return false;
+            }
+
+            // fill
+            fill_seq(dst, n);
+            mystl::fill(dst.begin() + a, dst.begin() + b, -1);
+            for (int i = 0; i < n; ++i)
+                if (dst[i] != (i >= a && i < b ? -1 : i))
+                    return false;
+
+            // find: 区间内的每个值都能找到， 区间外的值返回 last
+            for (int v = 0; v < n; ++v) {
+                small_deque::iterator it = mystl::find(src.begin() + a, src.begin() + b, v);
+                small_deque::iterator expect = (v >= a && v < b) ? src.begin() + v : src.begin() + b;
+                if (it != expect)
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
 int main() {
     mystl::deque<int> ilist;
     cout << "empty: " << ilist.empty() << endl;
@@ -53,5 +154,150 @@ int main() {
         cout << *iter << ' ';
     }
     cout << endl;
-}
 
+    cout << "test buffer size" << endl;
+    mystl::deque<int, 4> small;
+    for (int i = 0; i < 10; ++i) {
+        small.push_back(i);
+        small.push_front(-i);
+    }
+    cout << "buffer_size = " << mystl::deque<int, 4>::buffer_size
+         << ", default buffer_size = " << mystl::deque<int>::buffer_size << endl;
+    cout << "size = " << small.size() << ", small[3] = " << small[3]
+         << ", end - begin = " << (small.end() - small.begin()) << endl;
+    cout << "traverse : " ;
+    for (mystl::deque<int, 4>::iterator it = small.begin(); it != small.end(); ++it) {
+        cout << *it << ' ';
+    }
+    cout << endl;
+
+    cout << "test fifo with spare blocks" << endl;
+    for (int i = 0; i < 1000; ++i) {
+        small.push_back(i);
+        small.pop_front();
+    }
+    small.shrink_to_fit();
+    cout << "size = " << small.size() << ", front = " << small.front()
+         << ", back = " << small.back() << endl;
+
+    cout << "test map compaction" << endl;
+    mystl::deque<int, 4> big;
+    const size_t empty_usage = big.memory_usage();
+    for (int i = 0; i < 100000; ++i)
+        big.push_back(i);
+    const size_t peak_usage = big.memory_usage();
+    while (big.size() > 10)
+        big.pop_front();
+    big.shrink_to_fit();
+    cout << "size = " << big.size() << ", front = " << big.front()
+         << ", shrunk = " << (big.memory_usage() < peak_usage / 100) << endl;
+    big.clear();
+    big.shrink_to_fit();
+    cout << "after clear, back to empty usage = " << (big.memory_usage() == empty_usage) << endl;
+
+    // 先涨到很大， 再作为队列长期运行， 重新定位节点时 map 自动缩小
+    cout << "test map shrinks while draining as a queue" << endl;
+    mystl::deque<int, 4> fifo;
+    for (int i = 0; i < 100000; ++i)
+        fifo.push_back(i);
+    const size_t fifo_peak = fifo.memory_usage();
+    while (fifo.size() > 10)
+        fifo.pop_front();
+    for (int i = 0; i < 200000; ++i) {
+        fifo.push_back(i);
+        fifo.pop_front();
+    }
+    cout << "size = " << fifo.size() << ", back = " << fifo.back()
+         << ", shrunk = " << (fifo.memory_usage() < fifo_peak / 100) << endl;
+
+    cout << "test emplace and move" << endl;
+    mystl::deque<string> sdeque;
+    sdeque.emplace_back(3, 'b');
+    sdeque.emplace_front("front");
+    sdeque.push_back(string("back"));
+    sdeque.emplace(sdeque.begin() + 1, 2, 'm');
+    mystl::deque<string> moved(mystl::move(sdeque));
+    cout << "moved size = " << moved.size() << ", source size = " << sdeque.size() << endl;
+    cout << "traverse : " ;
+    for (mystl::deque<string>::iterator it = moved.begin(); it != moved.end(); ++it) {
+        cout << *it << ' ';
+    }
+    cout << endl;
+
+    cout << "test append, prepend and range insert" << endl;
+    int arr[] = {10, 11, 12, 13, 14, 15};
+    mystl::deque<int, 4> bulk;
+    bulk.append(arr, arr + 6);
+    bulk.prepend(arr, arr + 3);
+    bulk.insert(bulk.begin() + 4, arr + 3, arr + 6);
+    bulk.resize(14, 99);
+    cout << "size = " << bulk.size() << endl;
+    cout << "traverse : " ;
+    for (mystl::deque<int, 4>::iterator it = bulk.begin(); it != bulk.end(); ++it) {
+        cout << *it << ' ';
+    }
+    cout << endl;
+
+    cout << "test segmented copy, copy_backward, fill and find" << endl;
+    cout << "ok = " << (check_segmented(1) && check_segmented(7) && check_segmented(23)) << endl;
+
+    cout << "test range erase with move-only elements" << endl;
+    mystl::deque<unique_ptr<int>, 4> uptrs;
+    for (int i = 0; i < 20; ++i)
+        uptrs.push_back(unique_ptr<int>(new int(i)));
+    uptrs.erase(uptrs.begin() + 2, uptrs.begin() + 7);     // 前方元素少， 向后移动
+    uptrs.erase(uptrs.end() - 6, uptrs.end() - 2);         // 后方元素少， 向前移动
+    cout << "size = " << uptrs.size() << endl;
+    cout << "traverse : " ;
+    for (mystl::deque<unique_ptr<int>, 4>::iterator it = uptrs.begin(); it != uptrs.end(); ++it) {
+        cout << **it << ' ';
+    }
+    cout << endl;
+
+    cout << "test deque(n, x) with a throwing copy" << endl;
+    {
+        throwing_copy proto(7);
+        copy_budget = 9;    // 跨过两个缓冲区后抛出
+        bool caught = false;
+        try {
+            mystl::deque<throwing_copy, 4> bad(20, proto);
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+        copy_budget = -1;
+        cout << "caught = " << caught << ", live = " << live << endl;
+    }
+
+    cout << "test iterators survive pops" << endl;
+    mystl::deque<int, 4> popped;
+    for (int i = 0; i < 10000; ++i)
+        popped.push_back(i);
+    mystl::deque<int, 4>::iterator keep = popped.end() - 5;
+    while (popped.size() > 5)
+        popped.pop_front();
+    for (int i = 0; i < 3; ++i)
+        popped.pop_back();
+    cout << "keep = " << *keep << ", begin is keep = " << (popped.begin() == keep)
+         << ", end - keep = " << (popped.end() - keep) << endl;
+
+    cout << "test empty range erase with strings" << endl;
+    mystl::deque<string> words;
+    words.push_back("alpha");
+    words.push_back("beta");
+    words.push_back("gamma");
+    words.erase(words.begin() + 1, words.begin() + 1);
+    words.erase(words.begin() + 2, words.begin() + 2);
+    for (mystl::deque<string>::iterator it = words.begin(); it != words.end(); ++it)
+        cout << '[' << *it << "] ";
+    cout << endl;
+
+    cout << "test iterators survive range erase and resize" << endl;
+    mystl::deque<int, 4> trimmed;
+    for (int i = 0; i < 10000; ++i)
+        trimmed.push_back(i);
+    mystl::deque<int, 4>::iterator head = trimmed.end() - 10;
+    trimmed.erase(trimmed.begin(), trimmed.end() - 10);
+    trimmed.resize(3);
+    cout << "head = " << *head << ", begin is head = " << (trimmed.begin() == head)
+         << ", end - head = " << (trimmed.end() - head) << endl;
+}
@@ -0,0 +1,43 @@
+//
+// Created by fengjiaxin on 2023/4/24.
+//
+
+#include "../MyTinyStl/flat_hashtable.h"
+#include <iostream>
+#include "../MyTinyStl/hash_fun.h"
+#include "../MyTinyStl/functional.h"
+
+using namespace std;
+
+int main() {
+    mystl::flat_hashtable<int,int,mystl::hash<int>, mystl::identity<int>, mystl::equal_to<int>> iht(50,mystl::hash<int>(),mystl::equal_to<int>());
+    cout << iht.size() << endl;
+    cout << iht.bucket_count() << endl;
+    iht.insert_unique(59);
+    iht.insert_unique(63);
+    iht.insert_unique(108);
+    iht.insert_unique(2);
+    iht.insert_unique(53);
+    iht.insert_unique(55);
+    cout << iht.size() << endl;
+    cout << "insert 59 again: " << iht.insert_unique(59).second << endl;
+
+    cout << "test grow" << endl;
+    for (int i = 0; i < 1000; ++i)
+        iht.insert_unique(i);
+    cout << "size = " << iht.size() << ", bucket_count = " << iht.bucket_count() << endl;
+    cout << "find 500: " << *iht.find(500) << ", count 1001: " << iht.count(1001) << endl;
+
+    cout << "test erase" << endl;
+    for (int i = 0; i < 1000; i += 2)
+        iht.erase(i);
+    int sum = 0;
+    for (auto it = iht.begin(); it != iht.end(); ++it)
+        sum += *it;
+    cout << "size = " << iht.size() << ", sum = " << sum << endl;
+    mystl::hashtable_stats st = iht.stats();
+    cout << "stats: buckets = " << st.buckets << ", max probe = " << st.max_chain << ", tombstones = " << st.tombstones
+         << ", avg successful = " << st.avg_successful << ", avg unsuccessful = " << st.avg_unsuccessful << endl;
+    iht.clear();
+    cout << "after clear, size = " << iht.size() << ", empty = " << iht.empty() << endl;
+}
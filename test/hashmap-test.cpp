@@ -5,9 +5,25 @@
 #include <iostream>
 #include "../MyTinyStl/hash_map.h"
 #include "../MyTinyStl/hash_fun.h"
+#include "../MyTinyStl/string_view.h"
 #include <cstring>
+#include <string>
 using namespace std;
 
+struct counted {
+    static int constructed;
+    int v;
+    counted() : v(0) { ++constructed; }
+    counted(int x) : v(x) { ++constructed; }
+    counted(const counted& rhs) : v(rhs.v) { ++constructed; }
+    counted& operator=(const counted&) = default;
+};
+int counted::constructed = 0;
+
+struct string_hash {
+    size_t operator()(const std::string& s) const { return mystl::__stl_hash_string(s.c_str()); }
+};
+
 struct eqstr {
     bool operator()(const char* s1, const char* s2) const {
         return strcmp(s1,s2) == 0;
@@ -35,6 +51,68 @@ int main() {
     for (; ite1 != ite2; ++ite1)
         cout << ite1->first << " -> " << ite1->second << endl;
 
+    cout << "test flat_hashtable backend" << endl;
+    mystl::hash_map<int, int, mystl::hash<int>, mystl::equal_to<int>, mystl::flat_hashtable> squares;
+    for (int i = 0; i < 100; ++i)
+        squares[i] = i * i;
+    squares.erase(50);
+    cout << "size = " << squares.size() << ", 9 -> " << squares[9]
+         << ", count 50 = " << squares.count(50) << endl;
+
+    cout << "test incremental rehash" << endl;
+    mystl::hash_map<int, int> inc;
+    inc.incremental_rehash(4); // 每次插入最多搬迁 4 个旧桶
+    for (int i = 0; i < 1000; ++i)
+        inc[i] = i;
+    int sum = 0;
+    for (auto it = inc.begin(); it != inc.end(); ++it)
+        sum += it->second;
+    cout << "size = " << inc.size() << ", sum = " << sum << ", 999 -> " << inc[999]
+         << ", buckets = " << inc.bucket_count() << endl;
+    // 只有 erase 也能推进搬迁; 只读的表手动搬完
+    while (!inc.is_rehashing())
+        inc[inc.size()] = 0;
+    size_t erases = 0;
+    for (int i = 0; inc.is_rehashing(); ++i, ++erases)
+        inc.erase(-1 - i);
+    cout << "migration finished by erases: " << (erases > 0) << endl;
+    while (!inc.is_rehashing())
+        inc[inc.size()] = 0;
+    inc.complete_rehash();
+    cout << "after complete_rehash, rehashing = " << inc.is_rehashing() << ", size = " << inc.size() << endl;
+
+    cout << "test try_emplace / insert_or_assign" << endl;
+    mystl::hash_map<int, counted> cm;
+    cm.try_emplace(1, 10);
+    cm.try_emplace(1, 20); // 已存在， 不构造
+    cm[2].v = 5;
+    counted::constructed = 0;
+    cm[1].v += 1; // 命中， 不构造
+    cm[2].v += 1;
+    cout << "constructed on hit = " << counted::constructed << endl;
+    cm.insert_or_assign(1, counted(100));
+    cm.insert_or_assign(3, counted(3));
+    cm.emplace(4, counted(4));
+    cm.insert(std::pair<const int, counted>(5, counted(5)));
+    cout << "1 -> " << cm[1].v << ", 2 -> " << cm[2].v << ", size = " << cm.size() << endl;
 
+    mystl::hash_map<std::string, std::string, string_hash, mystl::equal_to<std::string>, mystl::flat_hashtable> sm;
+    std::string k = "key", v = "value";
+    sm.try_emplace(mystl::move(k), v);
+    sm.insert_or_assign(std::string("key"), std::string("other"));
+    sm.emplace("x", "y");
+    cout << "key -> " << sm["key"] << ", x -> " << sm["x"] << ", size = " << sm.size() << endl;
 
-}
\ No newline at end of file
+    cout << "test heterogeneous lookup" << endl;
+    mystl::hash_map<std::string, int, mystl::hash<mystl::string_view>, mystl::equal_to<mystl::string_view>> tm;
+    tm["alpha"] = 1;
+    tm["beta"] = 2;
+    tm["gamma"] = 3;
+    const char buffer[] = "xxbetayy"; // 网络缓冲区里的一段， 不以 '\0' 结尾
+    mystl::string_view key(buffer + 2, 4);
+    cout << "beta -> " << tm.find(key)->second << ", count gamma = " << tm.count("gamma")
+         << ", count delta = " << tm.count(mystl::string_view("delta")) << endl;
+    auto range = tm.equal_range(key);
+    cout << "equal_range size = " << (range.first != range.second ? 1 : 0)
+         << ", erase alpha = " << tm.erase("alpha") << ", size = " << tm.size() << endl;
+}
@@ -4,6 +4,8 @@
 
 #include "../MyTinyStl/hash_set.h"
 #include "../MyTinyStl/hash_fun.h"
+#include "../MyTinyStl/string_view.h"
+#include <string>
 #include <iostream>
 
 using namespace std;
@@ -21,4 +23,29 @@ int main() {
     for (; ite1 != ite2; ++ite1)
         cout << *ite1 << ' ';
     cout << endl;
-}
\ No newline at end of file
+
+    cout << "test flat_hashtable backend" << endl;
+    mystl::hash_set<int, mystl::hash<int>, mystl::equal_to<int>, mystl::flat_hashtable> fset;
+    fset.insert(59);
+    fset.insert(63);
+    fset.insert(108);
+    fset.insert(59);
+    cout << "size = " << fset.size() << ", count 63 = " << fset.count(63) << endl;
+
+    cout << "test emplace" << endl;
+    int x = 200;
+    bool first = fset.emplace(x).second;
+    bool again = fset.insert(mystl::move(x)).second;
+    cout << first << " " << again << ", size = " << fset.size() << endl;
+
+    cout << "test robin_hood_hashtable backend" << endl;
+    mystl::hash_set<std::string, mystl::hash<mystl::string_view>, mystl::equal_to<mystl::string_view>,
+                    mystl::robin_hood_hashtable> rset;
+    rset.insert("apple");
+    rset.insert("pear");
+    rset.insert("plum");
+    rset.insert("apple");
+    cout << "size = " << rset.size() << ", count pear = " << rset.count(mystl::string_view("pear")) << endl;
+    rset.erase("pear");
+    cout << "after erase, size = " << rset.size() << ", find plum = " << *rset.find("plum") << endl;
+}
@@ -4,11 +4,52 @@
 
 #include "../MyTinyStl/hashtable.h"
 #include <iostream>
+#include <thread>
+#include <vector>
+#include <chrono>
 #include "../MyTinyStl/hash_fun.h"
 #include "../MyTinyStl/functional.h"
 
 using namespace std;
 
+static size_t hash_calls = 0;
+
+// 只用低 3 位， 故意制造长链
+struct bad_hash {
+    size_t operator()(int x) const { return static_cast<size_t>(x & 7); }
+};
+
+static size_t resizes = 0;
+
+typedef mystl::hashtable<int,int,mystl::hash<int>, mystl::identity<int>, mystl::equal_to<int>> int_table;
+
+// 插入 n 个元素， 返回扩容到至少 65536 个桶的插入里最慢的一次的耗时(微秒)
+// 只看这几次大的扩容， 其他插入偶尔被调度或者分配器整理内存打断不影响结果
+static long worst_growing_insert(int_table& t, int n) {
+    long worst = 0;
+    for (int i = 0; i < n; ++i) {
+        const size_t before = t.bucket_count();
+        auto start = chrono::steady_clock::now();
+        t.insert_unique(i);
+        const long us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+        if (t.bucket_count() != before && t.bucket_count() >= 65536 && us > worst)
+            worst = us;
+    }
+    return worst;
+}
+
+void on_resize(size_t old_buckets, size_t new_buckets, uint64_t nanoseconds) {
+    ++resizes;
+    cout << "resize " << old_buckets << " -> " << new_buckets << ", took " << (nanoseconds > 0) << endl;
+}
+
+struct counting_hash {
+    size_t operator()(int x) const {
+        ++hash_calls;
+        return static_cast<size_t>(x);
+    }
+};
+
 int main() {
     mystl::hashtable<int,int,mystl::hash<int>, mystl::identity<int>, mystl::equal_to<int>> iht(50,mystl::hash<int>(),mystl::equal_to<int>());
     cout << iht.size() << endl;
@@ -20,4 +61,128 @@ int main() {
     iht.insert_unique(53);
     iht.insert_unique( 55);
     cout << iht.size() << endl;
-}
\ No newline at end of file
+
+    cout << "test pow2 bucket policy" << endl;
+    mystl::pow2_hashtable<int,int,mystl::hash<int>, mystl::identity<int>, mystl::equal_to<int>> pht(50,mystl::hash<int>(),mystl::equal_to<int>());
+    cout << pht.bucket_count() << endl;
+    for (int i = 0; i < 1000; ++i)
+        pht.insert_unique(i * 1024); // 低位全为 0， 需要靠混合打散
+    size_t max_chain = 0;
+    for (size_t n = 0; n < pht.bucket_count(); ++n)
+        max_chain = max_chain < pht.elems_in_bucket(n) ? pht.elems_in_bucket(n) : max_chain;
+    cout << pht.size() << " " << pht.bucket_count() << " max chain " << max_chain << endl;
+    cout << pht.count(1024 * 7) << " " << pht.count(7) << endl;
+
+    cout << "test cached hash code" << endl;
+    mystl::hashtable<int,int,counting_hash, mystl::identity<int>, mystl::equal_to<int>> cht(50,counting_hash(),mystl::equal_to<int>());
+    for (int i = 0; i < 200; ++i)
+        cht.insert_unique(i); // 中途会 rehash
+    const size_t calls_after_insert = hash_calls;
+    int sum = 0;
+    for (auto it = cht.begin(); it != cht.end(); ++it)
+        sum += *it;
+    cht.erase(cht.find(7));
+    // 遍历和按迭代器删除都不再计算 hash， 只有 find 算了一次
+    cout << sum << " " << cht.size() << " hash calls " << hash_calls - calls_after_insert << endl;
+
+    cout << "test begin on sparse table" << endl;
+    mystl::hashtable<int,int,mystl::hash<int>, mystl::identity<int>, mystl::equal_to<int>> sht(100000,mystl::hash<int>(),mystl::equal_to<int>());
+    for (int i = 0; i < 100; ++i)
+        sht.insert_unique(i * 997);
+    int erased = 0;
+    while (sht.begin() != sht.end()) { // erase 删空开头的桶时推进下界， begin() 不用从头找
+        sht.erase(sht.begin());
+        ++erased;
+    }
+    sht.insert_unique(5);
+    cout << erased << " " << sht.size() << " " << *sht.begin() << endl;
+
+    cout << "test load factor" << endl;
+    mystl::hashtable<int,int,mystl::hash<int>, mystl::identity<int>, mystl::equal_to<int>> lht(10,mystl::hash<int>(),mystl::equal_to<int>());
+    lht.max_load_factor(4.0f);
+    for (int i = 0; i < 1000; ++i)
+        lht.insert_unique(i);
+    cout << "buckets = " << lht.bucket_count() << ", load <= 4: " << (lht.load_factor() <= 4.0f) << endl;
+    lht.max_load_factor(1.0f);
+    lht.min_load_factor(0.1f);
+    lht.reserve(2000);
+    const size_t reserved_buckets = lht.bucket_count();
+    for (int i = 0; i < 1000; ++i)
+        lht.erase(i);
+    cout << "reserved buckets kept: " << (lht.bucket_count() == reserved_buckets) << endl;
+    lht.reserve(0);
+    for (int i = 0; i < 10000; ++i)
+        lht.insert_unique(i);
+    const size_t grown = lht.bucket_count();
+    for (int i = 100; i < 10000; ++i)
+        lht.erase(i);
+    cout << "shrunk: " << (lht.bucket_count() < grown) << ", size = " << lht.size()
+         << ", load = " << lht.load_factor() << endl;
+    lht.rehash(5000);
+    cout << "rehash(5000) buckets >= 5000: " << (lht.bucket_count() >= 5000) << ", count 42 = " << lht.count(42) << endl;
+
+    cout << "test stats" << endl;
+    mystl::hashtable<int,int,bad_hash, mystl::identity<int>, mystl::equal_to<int>> bht(10,bad_hash(),mystl::equal_to<int>());
+    bht.set_resize_callback(on_resize);
+    for (int i = 0; i < 100; ++i)
+        bht.insert_unique(i);
+    mystl::hashtable_stats st = bht.stats();
+    cout << "resizes = " << resizes << ", buckets = " << st.buckets << ", max chain = " << st.max_chain
+         << ", empty ratio = " << st.empty_ratio << endl;
+    cout << "avg successful = " << st.avg_successful << ", avg unsuccessful = " << st.avg_unsuccessful << endl;
+    st = lht.stats();
+    cout << "good hash: max chain = " << st.max_chain << ", chains of length 1 = " << st.histogram[1]
+         << ", empty = " << st.empty_buckets << endl;
+
+    // const 的表多个线程同时遍历， begin() 不写成员
+    cout << "test concurrent const iteration" << endl;
+    mystl::hashtable<int,int,mystl::hash<int>, mystl::identity<int>, mystl::equal_to<int>> rht(10000,mystl::hash<int>(),mystl::equal_to<int>());
+    for (int i = 0; i < 50; ++i)
+        rht.insert_unique(5000 + i * 31);
+    rht.erase(*rht.begin());
+    const auto& crht = rht;
+    std::vector<long> sums(4, 0);
+    std::vector<std::thread> readers;
+    for (size_t t = 0; t < sums.size(); ++t) {
+        readers.push_back(std::thread([t, &crht, &sums]() {
+            for (int round = 0; round < 100; ++round)
+                for (auto it = crht.begin(); it != crht.end(); ++it)
+                    sums[t] += *it;
+        }));
+    }
+    for (size_t t = 0; t < readers.size(); ++t)
+        readers[t].join();
+    cout << "sum = " << sums[0] << ", all threads equal = "
+         << (sums[1] == sums[0] && sums[2] == sums[0] && sums[3] == sums[0]) << endl;
+
+    // 按 key 删掉最前面的元素后， first_bucket 也要后移， 否则之后每次 begin() 都从删空的桶往后扫
+    cout << "test drain after erasing the front key" << endl;
+    mystl::hashtable<int,int,mystl::hash<int>, mystl::identity<int>, mystl::equal_to<int>> dht(200000,mystl::hash<int>(),mystl::equal_to<int>());
+    for (int i = 0; i < 20000; ++i)
+        dht.insert_unique(i * 9);
+    const int front = *dht.begin();
+    dht.erase(front);
+    size_t drained = 0;
+    size_t max_skips = dht.stats().begin_skips;
+    while (dht.begin() != dht.end()) {
+        dht.erase(dht.begin());
+        if (++drained % 1000 == 0 && dht.stats().begin_skips > max_skips)
+            max_skips = dht.stats().begin_skips;
+    }
+    cout << "drained = " << drained << ", max begin skips = " << max_skips << endl;
+
+    // 一次搬完时扩容要搬迁所有节点； 渐进式 rehash 的新桶数组不逐个清零， 扩容时只搬几个旧桶
+    // 两种方式在同一个进程里比较， 不依赖机器的绝对速度
+    cout << "test worst growing insert with incremental rehash" << endl;
+    long one_shot_worst, incremental_worst;
+    {
+        int_table one_shot(10, mystl::hash<int>(), mystl::equal_to<int>());
+        one_shot_worst = worst_growing_insert(one_shot, 1 << 20);
+    }
+    {
+        int_table incremental(10, mystl::hash<int>(), mystl::equal_to<int>());
+        incremental.incremental_rehash(16);
+        incremental_worst = worst_growing_insert(incremental, 1 << 20);
+    }
+    cout << "incremental worst < one-shot worst / 10: " << (incremental_worst * 10 < one_shot_worst) << endl;
+}
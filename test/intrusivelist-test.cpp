@@ -0,0 +1,49 @@
+//
+// Created by fengjiaxin on 2023/4/23.
+//
+
+#include "../MyTinyStl/intrusive_list.h"
+#include <iostream>
+using namespace std;
+
+struct Task {
+    int id;
+    mystl::intrusive_list_hook hook;
+    explicit Task(int i) : id(i) {}
+};
+
+int main() {
+    Task tasks[6] = {Task(0), Task(1), Task(2), Task(3), Task(4), Task(5)};
+    mystl::intrusive_list<Task, &Task::hook> ilist;
+    cout << boolalpha << "empty: " << ilist.empty() << endl;
+
+    for (int i = 1; i < 5; ++i)
+        ilist.push_back(tasks[i]);
+    ilist.push_front(tasks[0]);
+    cout << "after push, size = " << ilist.size() << ", linked = " << tasks[3].hook.is_linked()
+         << ", not linked = " << tasks[5].hook.is_linked() << endl;
+
+    mystl::intrusive_list<Task, &Task::hook>::iterator iter;
+    cout << "traverse : " ;
+    for (iter = ilist.begin();  iter != ilist.end() ; ++iter) {
+        cout << iter->id << ' ';
+    }
+    cout << endl;
+
+    cout << "test erase by reference" << endl;
+    ilist.erase(tasks[2]);
+    ilist.insert(ilist.iterator_to(tasks[4]), tasks[5]);
+    cout << "traverse : " ;
+    for (iter = ilist.begin();  iter != ilist.end() ; ++iter) {
+        cout << iter->id << ' ';
+    }
+    cout << endl;
+    cout << "size = " << ilist.size() << ", tasks[2] linked = " << tasks[2].hook.is_linked() << endl;
+
+    ilist.pop_front();
+    ilist.pop_back();
+    cout << "front = " << ilist.front().id << ", back = " << ilist.back().id << endl;
+
+    ilist.clear();
+    cout << "after clear, size = " << ilist.size() << ", tasks[1] linked = " << tasks[1].hook.is_linked() << endl;
+}
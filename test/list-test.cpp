@@ -52,5 +52,45 @@ int main() {
         cout << *iter << ' ';
     }
     cout << endl;
+
+    cout << "test splice, merge, reverse and remove_if" << endl;
+    mystl::list<int> odd, even;
+    for (int i = 0; i < 10; ++i) {
+        if (i % 2)
+            odd.push_back(i);
+        else
+            even.push_back(i);
+    }
+    odd.merge(even);
+    cout << "after merge, size = " << odd.size() << ", even size = " << even.size() << endl;
+    odd.reverse();
+    odd.remove_if([](int x) { return x % 3 == 0; });
+    cout << "reverse and remove_if : " ;
+    for (iter = odd.begin();  iter != odd.end() ; ++iter) {
+        cout << *iter << ' ';
+    }
+    cout << endl;
+    odd.splice(odd.begin(), ilist);
+    even.splice(even.end(), odd, odd.begin());
+    cout << "after splice, size = " << odd.size() << ", ilist size = " << ilist.size()
+         << ", even front = " << even.front() << endl;
+
+    cout << "test sort" << endl;
+    int arr[] = {5, 3, 9, 1, 7, 3, 8, 0, 6};
+    mystl::list<int> slist;
+    for (int i = 0; i < 9; ++i)
+        slist.push_back(arr[i]);
+    slist.sort();
+    cout << "ascending : " ;
+    for (iter = slist.begin();  iter != slist.end() ; ++iter) {
+        cout << *iter << ' ';
+    }
+    cout << endl;
+    slist.sort([](int x, int y) { return x > y; });
+    cout << "descending : " ;
+    for (iter = slist.begin();  iter != slist.end() ; ++iter) {
+        cout << *iter << ' ';
+    }
+    cout << endl;
 }
 
@@ -0,0 +1,74 @@
+//
+// Created by fengjiaxin on 2023/4/22.
+//
+
+#include "../MyTinyStl/ring_buffer.h"
+#include "../MyTinyStl/queue.h"
+#include <iostream>
+#include <stdexcept>
+using namespace std;
+
+int main() {
+    mystl::ring_buffer<int> ring;
+    cout << boolalpha << "empty: " << ring.empty() << endl;
+    for (int i = 0; i < 20; ++i)
+        ring.push_back(i);
+    cout << "size = " << ring.size() << ", capacity = " << ring.capacity() << endl;
+
+    // 头部弹出后再压入， 元素绕回缓冲区开头
+    for (int i = 0; i < 10; ++i)
+        ring.pop_front();
+    for (int i = 20; i < 34; ++i)
+        ring.push_back(i);
+    cout << "front = " << ring.front() << ", back = " << ring.back() << ", ring[5] = " << ring[5] << endl;
+    pair<int*, size_t> one = ring.array_one();
+    pair<int*, size_t> two = ring.array_two();
+    cout << "array_one size = " << one.second << ", array_two size = " << two.second
+         << ", total = " << one.second + two.second << endl;
+
+    long sum = 0;
+    mystl::ring_buffer<int>::iterator iter;
+    for (iter = ring.begin(); iter != ring.end(); ++iter)
+        sum += *iter;
+    cout << "sum = " << sum << ", distance = " << (ring.end() - ring.begin()) << endl;
+
+    ring.push_front(-1);
+    ring.pop_back();
+    cout << "after push_front/pop_back, front = " << ring.front() << ", back = " << ring.back() << endl;
+
+    cout << "test fixed capacity" << endl;
+    mystl::ring_buffer<int> fixed(5, mystl::fixed_capacity);
+    for (int i = 0; i < 8; ++i)
+        fixed.push_back(i);
+    cout << "size = " << fixed.size() << ", capacity = " << fixed.capacity() << ", full = " << fixed.full() << endl;
+    for (size_t i = 0; i < fixed.size(); ++i)
+        cout << fixed[i] << " ";
+    cout << endl;
+    fixed.push_back(fixed.front());
+    cout << "push_back(front), front = " << fixed.front() << ", back = " << fixed.back() << endl;
+
+    bool rejected = false;
+    try {
+        mystl::ring_buffer<int> zero(0, mystl::fixed_capacity);
+    } catch (const std::length_error&) {
+        rejected = true;
+    }
+    cout << "zero fixed capacity rejected = " << rejected << endl;
+
+    cout << "test queue<int, ring_buffer<int>>" << endl;
+    mystl::queue<int, mystl::ring_buffer<int>> iqueue;
+    for (int i = 1; i <= 5; ++i)
+        iqueue.push(i);
+    iqueue.pop();
+    cout << "size = " << iqueue.size() << ", front = " << iqueue.front() << ", back = " << iqueue.back() << endl;
+
+    cout << "test stack<int, ring_buffer<int>>" << endl;
+    mystl::stack<int, mystl::ring_buffer<int>> istack;
+    for (int i = 1; i <= 5; ++i)
+        istack.push(i);
+    istack.pop();
+    cout << "size = " << istack.size() << ", top = " << istack.top() << ", empty = " << istack.empty() << endl;
+
+    ring.clear();
+    cout << "after clear, size = " << ring.size() << ", capacity = " << ring.capacity() << endl;
+}
@@ -0,0 +1,167 @@
+//
+// Created by fengjiaxin on 2023/4/25.
+//
+
+#include "../MyTinyStl/robin_hood_hashtable.h"
+#include "../MyTinyStl/hashtable.h"
+#include <iostream>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include "../MyTinyStl/hash_fun.h"
+#include "../MyTinyStl/functional.h"
+
+using namespace std;
+
+typedef mystl::robin_hood_hashtable<int, int, mystl::hash<int>, mystl::identity<int>, mystl::equal_to<int>> rh_table;
+typedef mystl::hashtable<int, int, mystl::hash<int>, mystl::identity<int>, mystl::equal_to<int>> chain_table;
+
+// 打散的 key， 避免连续整数在开链法里正好顺序访问 bucket
+inline int scramble(int i) { return static_cast<int>(static_cast<unsigned>(i) * 2654435761u); }
+
+// 随机的查找顺序， 避免按插入顺序或固定步长访问节点
+inline int next_index(unsigned& seed, int n) {
+    seed = seed * 1103515245u + 12345u;
+    return static_cast<int>((seed >> 8) % static_cast<unsigned>(n));
+}
+
+// 第 move_budget 次移动构造时抛出一次异常， live 记录存活的对象数
+static int move_budget = -1;
+static int live = 0;
+struct throwing_move {
+    int key;
+    explicit throwing_move(int k) : key(k) { ++live; }
+    throwing_move(const throwing_move& rhs) : key(rhs.key) { ++live; }
+    throwing_move(throwing_move&& rhs) : key(rhs.key) {
+        if (move_budget == 0) {
+            move_budget = -1;
+            throw std::runtime_error("move");
+        }
+        if (move_budget > 0)
+            --move_budget;
+        ++live;
+    }
+    ~throwing_move() { --live; }
+};
+struct key_of {
+    int operator()(const throwing_move& x) const { return x.key; }
+};
+// 只有 4 个不同的 hash 值， 元素挤成一长段， 插入和删除都要移动很多元素
+struct four_hash {
+    size_t operator()(int x) const { return static_cast<size_t>(x & 3); }
+};
+typedef mystl::robin_hood_hashtable<throwing_move, int, four_hash, key_of, mystl::equal_to<int>> throwing_table;
+
+// 表里的元素个数和存活对象数一致， 遍历到的每个元素都能找到
+static bool consistent(throwing_table& t, int extra_live) {
+    size_t n = 0;
+    for (auto it = t.begin(); it != t.end(); ++it, ++n) {
+        if (t.find(it->key) == t.end())
+            return false;
+    }
+    return n == t.size() && static_cast<int>(t.size()) + extra_live == live;
+}
+
+// 插入 n 个 key， 再查找 2n 次(一半命中)， 再删掉一半 key 后查找 2n 次
+template <class Table>
+void bench(const char* name, int n) {
+    Table t(0, mystl::hash<int>(), mystl::equal_to<int>());
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i)
+        t.insert_unique(scramble(i));
+    auto mid = chrono::steady_clock::now();
+    size_t hits = 0;
+    unsigned seed = 1;
+    for (int i = 0; i < 2 * n; ++i)
+        hits += t.count(scramble(next_index(seed, 2 * n)));
+    auto erased = chrono::steady_clock::now();
+    for (int i = 0; i < n; i += 2)
+        t.erase(scramble(i));
+    for (int i = 0; i < 2 * n; ++i)
+        hits += t.count(scramble(next_index(seed, 2 * n)));
+    auto stop = chrono::steady_clock::now();
+    cout << name << ": insert " << chrono::duration_cast<chrono::milliseconds>(mid - start).count()
+         << "ms, lookup " << chrono::duration_cast<chrono::milliseconds>(erased - mid).count()
+         << "ms, erase + lookup " << chrono::duration_cast<chrono::milliseconds>(stop - erased).count()
+         << "ms, hits = " << hits << endl;
+}
+
+// 计时和机器有关， 默认不运行， 传入 --bench 参数时才比较开链法和 Robin Hood
+int main(int argc, char* argv[]) {
+    rh_table iht(50, mystl::hash<int>(), mystl::equal_to<int>());
+    cout << iht.size() << endl;
+    cout << iht.bucket_count() << endl;
+    iht.insert_unique(59);
+    iht.insert_unique(63);
+    iht.insert_unique(108);
+    iht.insert_unique(2);
+    iht.insert_unique(53);
+    iht.insert_unique(55);
+    cout << iht.size() << endl;
+    cout << "insert 59 again: " << iht.insert_unique(59).second << endl;
+
+    cout << "test grow" << endl;
+    for (int i = 0; i < 1000; ++i)
+        iht.insert_unique(i);
+    cout << "size = " << iht.size() << ", bucket_count = " << iht.bucket_count() << endl;
+    cout << "find 500: " << *iht.find(500) << ", count 1001: " << iht.count(1001) << endl;
+
+    cout << "test backward shift erase" << endl;
+    for (int i = 0; i < 1000; i += 2)
+        iht.erase(i);
+    int sum = 0;
+    bool all_found = true;
+    for (auto it = iht.begin(); it != iht.end(); ++it) {
+        sum += *it;
+        all_found = all_found && iht.find(*it) != iht.end();
+    }
+    cout << "size = " << iht.size() << ", sum = " << sum << ", all found = " << all_found << endl;
+
+    cout << "test insert_equal" << endl;
+    iht.insert_equal(1);
+    iht.insert_equal(1);
+    cout << "count 1 = " << iht.count(1) << ", erase 1 = " << iht.erase(1) << ", count 1 = " << iht.count(1) << endl;
+
+    mystl::hashtable_stats st = iht.stats();
+    cout << "stats: buckets = " << st.buckets << ", max probe = " << st.max_chain << ", probe 1 = " << st.histogram[1]
+         << ", avg successful = " << st.avg_successful << ", avg unsuccessful = " << st.avg_unsuccessful << endl;
+
+    rh_table copy = iht;
+    iht.clear();
+    cout << "after clear, size = " << iht.size() << ", copy size = " << copy.size() << endl;
+
+    cout << "test throwing move during shifts" << endl;
+    {
+        throwing_table tt(64, four_hash(), mystl::equal_to<int>());
+        for (int i = 0; i < 40; ++i)
+            tt.insert_unique(throwing_move(i));
+        // 第 3 次移动抛出: 至少已经后移了两个元素， 插入要把它们移回原位
+        bool caught = false;
+        int failed = 39;
+        while (!caught && ++failed < 1000) {
+            move_budget = 2;
+            try {
+                tt.insert_unique(throwing_move(failed));
+            } catch (const std::runtime_error&) {
+                caught = true;
+            }
+        }
+        move_budget = -1;
+        bool all_kept = true;
+        for (int i = 0; i < failed; ++i)
+            all_kept = all_kept && tt.count(i) == 1;
+        cout << "insert: caught = " << caught << ", all kept = " << all_kept
+             << ", consistent = " << consistent(tt, 0) << ", count failed = " << tt.count(failed) << endl;
+        move_budget = 2; // 删除 0 后 backward shift 中途抛出， 这一段剩下的元素被析构
+        const size_t before = tt.size();
+        tt.erase(0);
+        cout << "erase: lost some = " << (tt.size() + 1 < before) << ", consistent = " << consistent(tt, 0) << endl;
+    }
+    cout << "live after destruction = " << live << endl;
+
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        cout << "benchmark, 1000000 int keys" << endl;
+        bench<chain_table>("chained   ", 1000000);
+        bench<rh_table>("robin hood", 1000000);
+    }
+}
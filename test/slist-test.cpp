@@ -0,0 +1,79 @@
+//
+// Created by fengjiaxin on 2023/4/23.
+//
+
+#include "../MyTinyStl/slist.h"
+#include <iostream>
+#include <thread>
+#include <vector>
+using namespace std;
+
+int main() {
+    mystl::slist<int> islist;
+    cout << boolalpha << "empty: " << islist.empty() << endl;
+    cout << "node size = " << sizeof(mystl::__slist_node<int>) << endl;
+
+    for (int i = 0; i < 5; ++i)
+        islist.push_front(i);
+    cout << "after push_front, size = " << islist.size() << ", front = " << islist.front() << endl;
+
+    mystl::slist<int>::iterator iter;
+    cout << "traverse : " ;
+    for (iter = islist.begin();  iter != islist.end() ; ++iter) {
+        cout << *iter << ' ';
+    }
+    cout << endl;
+
+    cout << "test insert_after and erase_after" << endl;
+    iter = islist.begin();
+    ++iter;
+    iter = islist.insert_after(iter, 66);
+    islist.insert_after(iter, 2, 77);
+    islist.erase_after(islist.begin());
+    cout << "traverse : " ;
+    for (iter = islist.begin();  iter != islist.end() ; ++iter) {
+        cout << *iter << ' ';
+    }
+    cout << endl;
+
+    cout << "test splice_after and reverse" << endl;
+    mystl::slist<int> other(3, 9);
+    islist.splice_after(islist.before_begin(), other);
+    islist.reverse();
+    cout << "traverse : " ;
+    for (iter = islist.begin();  iter != islist.end() ; ++iter) {
+        cout << *iter << ' ';
+    }
+    cout << endl;
+    cout << "size = " << islist.size() << ", other size = " << other.size() << endl;
+
+    islist.pop_front();
+    cout << "after pop_front, front = " << islist.front() << endl;
+    islist.clear();
+    cout << "after clear, size = " << islist.size() << ", empty = " << islist.empty() << endl;
+
+    // 每个线程修改自己的 slist， 节点来自同一个内存池
+    cout << "test slists in different threads" << endl;
+    const int nthreads = 4;
+    std::vector<long> sums(nthreads, 0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < nthreads; ++t) {
+        workers.push_back(std::thread([t, &sums]() {
+            mystl::slist<int> mine;
+            for (int round = 0; round < 50; ++round) {
+                for (int i = 0; i < 1000; ++i)
+                    mine.push_front(i);
+                while (mine.size() > 500)
+                    mine.pop_front();
+            }
+            for (mystl::slist<int>::iterator it = mine.begin(); it != mine.end(); ++it)
+                sums[t] += *it;
+        }));
+    }
+    bool same = true;
+    for (int t = 0; t < nthreads; ++t) {
+        workers[t].join();
+        same = same && sums[t] == sums[0];
+    }
+    cout << "sum = " << sums[0] << ", all threads equal = " << same << endl;
+}
@@ -0,0 +1,41 @@
+//
+// Created by fengjiaxin on 2023/4/21.
+//
+
+#include "../MyTinyStl/stable_vector.h"
+#include <iostream>
+using namespace std;
+
+int main() {
+    mystl::stable_vector<int> ivec;
+    cout << boolalpha << "empty: " << ivec.empty() << endl;
+    cout << "size = " << ivec.size() << ", capacity = " << ivec.capacity() << endl;
+
+    ivec.push_back(0);
+    int* first = &ivec.front();
+    for (int i = 1; i < 100; ++i)
+        ivec.push_back(i);
+    cout << "after push_back, size = " << ivec.size()
+         << ", capacity = " << ivec.capacity() << endl;
+    cout << "reference stable: " << (first == &ivec[0]) << endl;
+
+    cout << "ivec[15] = " << ivec[15] << ", ivec[16] = " << ivec[16]
+         << ", ivec[47] = " << ivec[47] << ", ivec[48] = " << ivec[48] << endl;
+    cout << "back = " << ivec.back() << ", front = " << ivec.front() << endl;
+
+    long sum = 0;
+    mystl::stable_vector<int>::iterator iter;
+    for (iter = ivec.begin(); iter != ivec.end(); ++iter)
+        sum += *iter;
+    cout << "sum = " << sum << ", distance = " << (ivec.end() - ivec.begin()) << endl;
+
+    ivec.pop_back();
+    cout << "after pop back, back = " << ivec.back() << endl;
+    const mystl::stable_vector<int>& civec = ivec;
+    cout << "const front = " << civec.front() << ", const back = " << civec.back() << endl;
+
+    cout << "test clear" << endl;
+    ivec.clear();
+    cout << "after clear, size = " << ivec.size()
+         << ", capacity = " << ivec.capacity() << endl;
+}
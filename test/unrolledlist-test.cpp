@@ -0,0 +1,88 @@
+//
+// Created by fengjiaxin on 2023/4/23.
+//
+
+#include "../MyTinyStl/unrolled_list.h"
+#include <iostream>
+using namespace std;
+
+// 移动构造没有 noexcept， 复制构造在 budget 用完时抛出异常
+static int copy_budget = 1000000;
+
+struct fragile {
+    int v;
+    fragile(int x) : v(x) {}
+    fragile(const fragile& rhs) : v(rhs.v) {
+        if (--copy_budget < 0)
+            throw 0;
+    }
+    fragile(fragile&& rhs) : v(rhs.v) { rhs.v = -1; }
+    fragile& operator=(const fragile& rhs) {
+        v = rhs.v;
+        return *this;
+    }
+};
+
+int main() {
+    mystl::unrolled_list<int, 4> ilist;
+    cout << boolalpha << "empty: " << ilist.empty() << endl;
+    cout << "node capacity = " << mystl::unrolled_list<int, 4>::node_capacity
+         << ", default node capacity = " << mystl::unrolled_list<int>::node_capacity << endl;
+
+    for (int i = 0; i < 10; ++i)
+        ilist.push_back(i);
+    ilist.push_front(-1);
+    ilist.push_front(-2);
+    cout << "after push, size = " << ilist.size() << endl;
+
+    mystl::unrolled_list<int, 4>::iterator iter;
+    cout << "traverse : " ;
+    for (iter = ilist.begin();  iter != ilist.end() ; ++iter) {
+        cout << *iter << ' ';
+    }
+    cout << endl;
+    cout << "back = " << ilist.back() << ", front = " << ilist.front() << endl;
+
+    cout << "test insert and erase" << endl;
+    iter = ilist.begin();
+    for (int i = 0; i < 5; ++i)
+        ++iter;
+    iter = ilist.insert(iter, 66);
+    cout << "inserted " << *iter << ", next = " << *(++iter) << endl;
+    iter = ilist.begin();
+    while (iter != ilist.end()) {
+        if (*iter % 2 == 0)
+            iter = ilist.erase(iter);
+        else
+            ++iter;
+    }
+    cout << "traverse : " ;
+    for (iter = ilist.begin();  iter != ilist.end() ; ++iter) {
+        cout << *iter << ' ';
+    }
+    cout << endl;
+
+    ilist.pop_front();
+    ilist.pop_back();
+    cout << "after pop, size = " << ilist.size() << ", front = " << ilist.front()
+         << ", back = " << ilist.back() << endl;
+
+    ilist.clear();
+    cout << "after clear, size = " << ilist.size() << endl;
+
+    cout << "test node split fails cleanly" << endl;
+    mystl::unrolled_list<fragile, 4> flist;
+    for (int i = 0; i < 4; ++i)
+        flist.push_back(fragile(i));
+    copy_budget = 1;
+    try {
+        flist.insert(++flist.begin(), fragile(9));
+    } catch (int) {
+        cout << "insert threw" << endl;
+    }
+    copy_budget = 1000000;
+    cout << "size = " << flist.size() << ", traverse : ";
+    for (mystl::unrolled_list<fragile, 4>::iterator it = flist.begin(); it != flist.end(); ++it)
+        cout << it->v << ' ';
+    cout << endl;
+}
@@ -72,10 +72,40 @@ int main() {
     }
     cout << endl;
 
+    cout << "test unordered_erase" << endl;
+    iter = mystl::find(ivec.begin(), ivec.end(), 0);
+    if (iter != ivec.end())
+        ivec.unordered_erase(iter);
+    else
+        cout << "0 not found" << endl;
+    cout << "traverse : " ;
+    for (iter = ivec.begin();  iter != ivec.end() ; ++iter) {
+        cout << *iter << ' ';
+    }
+    cout << endl;
+
+    cout << "test erase_if" << endl;
+    size_t removed = ivec.erase_if([](int x) { return x == 66; });
+    cout << "removed = " << removed << ", size = " << ivec.size() << endl;
+    cout << "traverse : " ;
+    for (iter = ivec.begin();  iter != ivec.end() ; ++iter) {
+        cout << *iter << ' ';
+    }
+    cout << endl;
+
     cout << "test clear" << endl;
     ivec.clear();
     cout << "after clear ,size = " << ivec.size()
          << ",capacity = " << ivec.capacity() << endl;
 
+    cout << "test parallel init" << endl;
+    mystl::vector<int> big(1 << 24, 7, mystl::parallel_init);
+    big.insert(big.begin() + 1, 1 << 23, 8, mystl::parallel_init);
+    long long sum = 0;
+    for (iter = big.begin(); iter != big.end(); ++iter)
+        sum += *iter;
+    cout << "size = " << big.size() << ", sum = " << sum
+         << ", front = " << big.front() << ", big[1] = " << big[1] << endl;
+
 }
 